@@ -0,0 +1,177 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "archiveinspector.h"
+
+#include <QDebug>
+
+#include <KArchive/KArchiveDirectory>
+#include <KArchive/KArchiveEntry>
+#include <KArchive/KArchiveFile>
+
+namespace Latte {
+
+ArchiveInspector::ArchiveInspector(const QString &file)
+    : m_archive(file, QStringLiteral("application/x-tar"))
+{
+    if (m_archive.open(QIODevice::ReadOnly)) {
+        inspect();
+    }
+}
+
+ArchiveInspector::~ArchiveInspector()
+{
+    if (m_archive.isOpen()) {
+        m_archive.close();
+    }
+}
+
+bool ArchiveInspector::isValid() const
+{
+    return m_archive.isOpen() && m_version != Importer::UnknownFileType;
+}
+
+Importer::LatteFileVersion ArchiveInspector::version() const
+{
+    return m_version;
+}
+
+void ArchiveInspector::inspect()
+{
+    const KArchiveDirectory *rootDir = m_archive.directory();
+
+    if (!rootDir) {
+        return;
+    }
+
+    bool version1rc = false;
+    bool version1applets = false;
+    bool version2rc = false;
+    bool version2LatteDir = false;
+    bool unknownEntries = false;
+
+    //rc file
+    int rcVersion = configVersion(fileData(QStringLiteral("lattedockrc")), QStringLiteral("UniversalSettings"));
+
+    if (rootDir->file(QStringLiteral("lattedockrc"))) {
+        if (rcVersion == 1) {
+            version1rc = true;
+        } else if (rcVersion == 2) {
+            version2rc = true;
+        }
+    }
+
+    //applets file
+    if (version1rc && rootDir->file(QStringLiteral("lattedock-appletsrc"))) {
+        int appletsVersion = configVersion(fileData(QStringLiteral("lattedock-appletsrc")), QStringLiteral("LayoutSettings"));
+        version1applets = (appletsVersion == 1);
+    }
+
+    //latte directory
+    const KArchiveEntry *latteEntry = rootDir->entry(QStringLiteral("latte"));
+    version2LatteDir = latteEntry && latteEntry->isDirectory();
+
+    //! old configuration files contain only the two rc files
+    foreach (auto &name, rootDir->entries()) {
+        if (name != QLatin1String("lattedockrc") && name != QLatin1String("lattedock-appletsrc")) {
+            unknownEntries = true;
+        }
+    }
+
+    if (version1rc && version1applets && !unknownEntries) {
+        m_version = Importer::ConfigVersion1;
+    } else if (version2rc && version2LatteDir) {
+        m_version = Importer::ConfigVersion2;
+    }
+}
+
+QByteArray ArchiveInspector::fileData(const QString &name) const
+{
+    if (!m_archive.isOpen() || !m_archive.directory()) {
+        return QByteArray();
+    }
+
+    const KArchiveFile *fileEntry = m_archive.directory()->file(name);
+
+    return fileEntry ? fileEntry->data() : QByteArray();
+}
+
+bool ArchiveInspector::extractTo(const QString &directory) const
+{
+    if (!m_archive.isOpen() || !m_archive.directory()) {
+        return false;
+    }
+
+    return m_archive.directory()->copyTo(directory);
+}
+
+bool ArchiveInspector::extractFilesTo(const QStringList &names, const QString &directory) const
+{
+    if (!m_archive.isOpen() || !m_archive.directory()) {
+        return false;
+    }
+
+    foreach (auto &name, names) {
+        const KArchiveFile *fileEntry = m_archive.directory()->file(name);
+
+        if (!fileEntry || !fileEntry->copyTo(directory)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int ArchiveInspector::configVersion(const QByteArray &data, const QString &group, int defaultVersion)
+{
+    //! a minimal reader of the KConfig format, only the top level groups
+    //! and their entries are needed in order to find a version
+    const QByteArray groupHeader = "[" + group.toUtf8() + "]";
+    bool inGroup{false};
+    int start{0};
+
+    while (start < data.size()) {
+        int end = data.indexOf('\n', start);
+
+        if (end < 0) {
+            end = data.size();
+        }
+
+        const QByteArray line = data.mid(start, end - start).trimmed();
+        start = end + 1;
+
+        if (line.startsWith('[')) {
+            inGroup = (line == groupHeader);
+        } else if (inGroup) {
+            int separator = line.indexOf('=');
+
+            if (separator > 0 && line.left(separator).trimmed() == "version") {
+                bool ok{false};
+                int version = line.mid(separator + 1).trimmed().toInt(&ok);
+
+                return ok ? version : defaultVersion;
+            }
+        }
+    }
+
+    return defaultVersion;
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARCHIVEINSPECTOR_H
+#define ARCHIVEINSPECTOR_H
+
+#include "importer.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <KArchive/KTar>
+
+namespace Latte {
+
+//! This class inspects a .latterc archive without extracting it. Only the
+//! headers of the archive and the small rc files are read in memory, that
+//! way the file version is found and its structure is validated before
+//! anything is written on disk. The same instance is used afterwards in
+//! order to extract the archive, so it is read at most once.
+class ArchiveInspector {
+public:
+    ArchiveInspector(const QString &file);
+    ~ArchiveInspector();
+
+    bool isValid() const;
+
+    Importer::LatteFileVersion version() const;
+
+    //! the content of a top level file of the archive
+    QByteArray fileData(const QString &name) const;
+
+    //! extracts all the archive entries in the directory
+    bool extractTo(const QString &directory) const;
+    //! extracts only the provided top level files in the directory
+    bool extractFilesTo(const QStringList &names, const QString &directory) const;
+
+    //! the version entry of a group from the content of a config file,
+    //! defaultVersion is returned when it is not found
+    static int configVersion(const QByteArray &data, const QString &group, int defaultVersion = 1);
+
+private:
+    void inspect();
+
+private:
+    Importer::LatteFileVersion m_version{Importer::UnknownFileType};
+
+    KTar m_archive;
+};
+
+}
+
+#endif // ARCHIVEINSPECTOR_H
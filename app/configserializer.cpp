@@ -0,0 +1,162 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "configserializer.h"
+
+#include <QCryptographicHash>
+
+namespace Latte {
+
+namespace {
+QByteArray escaped(const QString &text, const QString &specials)
+{
+    QString result;
+    result.reserve(text.size());
+
+    for (const QChar &c : text) {
+        if (c == QLatin1Char('\n')) {
+            result += QLatin1String("\\n");
+        } else if (c == QLatin1Char('\\') || specials.contains(c)) {
+            result += QLatin1Char('\\');
+            result += c;
+        } else {
+            result += c;
+        }
+    }
+
+    return result.toUtf8();
+}
+
+QString unescaped(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+
+    for (int i = 0; i < text.size(); ++i) {
+        if (text[i] == QLatin1Char('\\') && i + 1 < text.size()) {
+            ++i;
+            result += (text[i] == QLatin1Char('n')) ? QChar(QLatin1Char('\n')) : text[i];
+        } else {
+            result += text[i];
+        }
+    }
+
+    return result;
+}
+
+//! the position of the first character that is not escaped, -1 if not found
+int unescapedIndexOf(const QString &text, QChar c, int from = 0)
+{
+    for (int i = from; i < text.size(); ++i) {
+        if (text[i] == QLatin1Char('\\')) {
+            ++i;
+        } else if (text[i] == c) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+}
+
+QByteArray ConfigSerializer::groupData(const KConfigGroup &group, const QString &excludedGroup, const QStringList &excludedKeys)
+{
+    QByteArray data;
+    appendGroupData(group, QStringList(), excludedGroup, excludedKeys, data);
+
+    return data;
+}
+
+void ConfigSerializer::appendGroupData(const KConfigGroup &group, const QStringList &path, const QString &excludedGroup,
+                                       const QStringList &excludedKeys, QByteArray &data)
+{
+    const auto entries = group.entryMap();
+    QByteArray entriesData;
+
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (!excludedKeys.contains(it.key())) {
+            //! a key that starts with [ must not be read back as a group header
+            entriesData += escaped(it.key(), QStringLiteral("=[")) + '=' + escaped(it.value(), QString()) + '\n';
+        }
+    }
+
+    if (!entriesData.isEmpty()) {
+        if (!path.isEmpty()) {
+            foreach (auto name, path) {
+                data += '[' + escaped(name, QStringLiteral("[]")) + ']';
+            }
+
+            data += '\n';
+        }
+
+        data += entriesData;
+    }
+
+    QStringList subgroups = group.groupList();
+    subgroups.sort();
+
+    foreach (auto subgroup, subgroups) {
+        if (subgroup != excludedGroup) {
+            appendGroupData(group.group(subgroup), QStringList(path) << subgroup, QString(), QStringList(), data);
+        }
+    }
+}
+
+void ConfigSerializer::readGroupData(const QByteArray &data, KConfigGroup &group)
+{
+    KConfigGroup current = group;
+
+    foreach (auto lineData, data.split('\n')) {
+        QString line = QString::fromUtf8(lineData);
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        if (line.startsWith(QLatin1Char('['))) {
+            current = group;
+            int start = 0;
+
+            while (start < line.size() && line[start] == QLatin1Char('[')) {
+                int end = unescapedIndexOf(line, QLatin1Char(']'), start + 1);
+
+                if (end < 0) {
+                    break;
+                }
+
+                current = current.group(unescaped(line.mid(start + 1, end - start - 1)));
+                start = end + 1;
+            }
+        } else {
+            int separator = unescapedIndexOf(line, QLatin1Char('='));
+
+            if (separator > 0) {
+                current.writeEntry(unescaped(line.left(separator)), unescaped(line.mid(separator + 1)));
+            }
+        }
+    }
+}
+
+QByteArray ConfigSerializer::digest(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGSERIALIZER_H
+#define CONFIGSERIALIZER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <KConfigGroup>
+
+namespace Latte {
+
+//! This class provides a deterministic text form of a config group, its
+//! entries and its subgroups sorted by name. It is used for the digests of
+//! the layout files and for the blobs of the layouts packages, so identical
+//! groups always have identical data and digests.
+class ConfigSerializer {
+public:
+    //! excludedGroup is a direct subgroup and excludedKeys are direct entries
+    //! of the group that are not serialized
+    static QByteArray groupData(const KConfigGroup &group, const QString &excludedGroup = QString(),
+                                const QStringList &excludedKeys = QStringList());
+    //! writes the serialized entries and subgroups in the group
+    static void readGroupData(const QByteArray &data, KConfigGroup &group);
+
+    //! the hex sha1 digest of the data
+    static QByteArray digest(const QByteArray &data);
+
+private:
+    static void appendGroupData(const KConfigGroup &group, const QStringList &path, const QString &excludedGroup,
+                                const QStringList &excludedKeys, QByteArray &data);
+};
+
+}
+
+#endif // CONFIGSERIALIZER_H
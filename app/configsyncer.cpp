@@ -0,0 +1,234 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "configsyncer.h"
+
+#include <QDebug>
+#include <QRunnable>
+
+#include <KConfig>
+
+namespace Latte {
+
+//! the period during which the mutations are coalesced
+const int COALESCEINTERVAL = 500;
+
+class ConfigWriteTask : public QRunnable {
+public:
+    ConfigWriteTask(const QString &file, QStandardPaths::StandardLocation location, const QList<ConfigSyncer::Mutation> &mutations)
+        : m_file(file),
+          m_location(location),
+          m_mutations(mutations)
+    {
+    }
+
+    void run() override
+    {
+        ConfigSyncer::writeMutations(m_file, m_location, m_mutations);
+    }
+
+private:
+    QString m_file;
+    QStandardPaths::StandardLocation m_location;
+    QList<ConfigSyncer::Mutation> m_mutations;
+};
+
+class ConfigSyncerSingleton {
+public:
+    ConfigSyncerSingleton() {
+    }
+
+    ConfigSyncer self;
+};
+
+Q_GLOBAL_STATIC(ConfigSyncerSingleton, privateConfigSyncerSelf)
+
+ConfigSyncer *ConfigSyncer::self()
+{
+    return &privateConfigSyncerSelf->self;
+}
+
+ConfigSyncer::ConfigSyncer(QObject *parent)
+    : QObject(parent)
+{
+    m_workerPool.setMaxThreadCount(1);
+    m_workerPool.setExpiryTimeout(-1);
+
+    m_coalesceTimer.setSingleShot(true);
+    m_coalesceTimer.setInterval(COALESCEINTERVAL);
+    connect(&m_coalesceTimer, &QTimer::timeout, this, &ConfigSyncer::submitPending);
+}
+
+ConfigSyncer::~ConfigSyncer()
+{
+    flush();
+
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+void ConfigSyncer::deleteEntry(KConfigGroup &group, const QString &key)
+{
+    bool wasDirty = isDirty(group);
+    group.deleteEntry(key);
+    enqueue(DeleteEntry, group, key);
+    markAsClean(group, wasDirty);
+}
+
+void ConfigSyncer::deleteGroup(KConfigGroup &group)
+{
+    bool wasDirty = isDirty(group);
+    //! the path must be found before the group is deleted
+    enqueue(DeleteGroup, group);
+    group.deleteGroup();
+    markAsClean(group, wasDirty);
+}
+
+void ConfigSyncer::flush()
+{
+    submitPending();
+    m_workerPool.waitForDone();
+}
+
+void ConfigSyncer::submitPending()
+{
+    m_coalesceTimer.stop();
+
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (!it.value().isEmpty()) {
+            m_workerPool.start(new ConfigWriteTask(it.key(), m_locations.value(it.key()), it.value()));
+        }
+    }
+
+    m_pending.clear();
+}
+
+void ConfigSyncer::enqueue(OperationType type, const KConfigGroup &group, const QString &key, const QString &value)
+{
+    if (!group.config()) {
+        return;
+    }
+
+    QString file = group.config()->name();
+
+    Mutation mutation;
+    mutation.type = type;
+    mutation.groupPath = groupPath(group);
+    mutation.key = key;
+    mutation.value = value;
+
+    QList<Mutation> &mutations = m_pending[file];
+    m_locations[file] = group.config()->locationType();
+
+    //! coalesce with a previous mutation of the same entry or group, a later
+    //! deletion of the group or one of its parents stops the search because
+    //! the order of the mutations matters in such case
+    for (int i = mutations.count() - 1; i >= 0; --i) {
+        const Mutation &previous = mutations.at(i);
+
+        if (previous.type == DeleteGroup) {
+            if (previous.groupPath == mutation.groupPath && type == DeleteGroup) {
+                mutations.removeAt(i);
+                continue;
+            }
+
+            bool isParent = previous.groupPath.count() <= mutation.groupPath.count()
+                            && mutation.groupPath.mid(0, previous.groupPath.count()) == previous.groupPath;
+
+            if (isParent) {
+                break;
+            }
+        } else if (type != DeleteGroup && previous.groupPath == mutation.groupPath && previous.key == key) {
+            mutations.removeAt(i);
+            break;
+        }
+    }
+
+    mutations.append(mutation);
+
+    if (!m_coalesceTimer.isActive()) {
+        m_coalesceTimer.start();
+    }
+}
+
+QStringList ConfigSyncer::groupPath(const KConfigGroup &group) const
+{
+    QStringList path;
+    KConfigGroup current = group;
+
+    //! the root group of a config file is named <default>
+    while (current.isValid() && current.name() != QLatin1String("<default>") && path.count() < 32) {
+        path.prepend(current.name());
+        current = current.parent();
+    }
+
+    return path;
+}
+
+bool ConfigSyncer::isDirty(const KConfigGroup &group) const
+{
+    return group.config() && group.config()->isDirty();
+}
+
+void ConfigSyncer::markAsClean(KConfigGroup &group, bool wasDirty)
+{
+    //! the unsaved changes of other writers must still be synced by them
+    if (!wasDirty && group.config()) {
+        group.config()->markAsClean();
+    }
+}
+
+void ConfigSyncer::writeMutations(const QString &file, QStandardPaths::StandardLocation location, const QList<Mutation> &mutations)
+{
+    //! a private instance for the worker thread, KConfig merges the changed
+    //! entries with the file on disk and writes it through QSaveFile
+    KConfig config(file, KConfig::SimpleConfig, location);
+
+    foreach (auto mutation, mutations) {
+        if (mutation.groupPath.isEmpty()) {
+            continue;
+        }
+
+        KConfigGroup group(&config, mutation.groupPath.first());
+
+        for (int i = 1; i < mutation.groupPath.count(); ++i) {
+            group = group.group(mutation.groupPath.at(i));
+        }
+
+        switch (mutation.type) {
+            case WriteEntry:
+                group.writeEntry(mutation.key, mutation.value);
+                break;
+
+            case DeleteEntry:
+                group.deleteEntry(mutation.key);
+                break;
+
+            case DeleteGroup:
+                group.deleteGroup();
+                break;
+        }
+    }
+
+    if (!config.sync()) {
+        qWarning() << "ConfigSyncer :: failed to write :: " << file;
+    }
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGSYNCER_H
+#define CONFIGSYNCER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <KConfigGroup>
+
+namespace Latte {
+
+class ConfigWriteTask;
+
+//! This class is responsible to store the Latte configuration files on disk
+//! without blocking the GUI thread. The callers still update their KConfigGroup
+//! in memory, the relevant mutation is recorded and all the mutations of a short
+//! period are coalesced and written from a worker thread with one sync per file.
+//! The in memory config is marked clean afterwards, so it is not synced again
+//! from the GUI thread.
+class ConfigSyncer : public QObject {
+    Q_OBJECT
+
+public:
+    static ConfigSyncer *self();
+
+    ConfigSyncer(QObject *parent = nullptr);
+    ~ConfigSyncer() override;
+
+    template<typename T>
+    void writeEntry(KConfigGroup &group, const QString &key, const T &value)
+    {
+        bool wasDirty = isDirty(group);
+        group.writeEntry(key, value);
+        //! KConfig stores everything as strings, that way any type is supported
+        enqueue(WriteEntry, group, key, group.readEntry(key, QString()));
+        markAsClean(group, wasDirty);
+    }
+
+    void deleteEntry(KConfigGroup &group, const QString &key);
+    void deleteGroup(KConfigGroup &group);
+
+    //! blocks until all the recorded mutations are written on disk, it must be
+    //! called before quitting and before reading a file from disk e.g. on import
+    void flush();
+
+private slots:
+    void submitPending();
+
+private:
+    enum OperationType {
+        WriteEntry = 0,
+        DeleteEntry,
+        DeleteGroup
+    };
+
+    struct Mutation {
+        OperationType type{WriteEntry};
+        QStringList groupPath;
+        QString key;
+        QString value;
+    };
+
+    void enqueue(OperationType type, const KConfigGroup &group, const QString &key = QString(), const QString &value = QString());
+    QStringList groupPath(const KConfigGroup &group) const;
+
+    bool isDirty(const KConfigGroup &group) const;
+    //! the mutation is written from the worker, so the in memory config is
+    //! marked clean unless it had unsaved changes from other writers before
+    void markAsClean(KConfigGroup &group, bool wasDirty);
+
+    static void writeMutations(const QString &file, QStandardPaths::StandardLocation location, const QList<Mutation> &mutations);
+
+private:
+    //! it is used in order to coalesce the mutations of a short period
+    QTimer m_coalesceTimer;
+
+    //! a single worker thread, so the files are written in the order they were requested
+    QThreadPool m_workerPool;
+
+    //! config file -> pending mutations in their order
+    QHash<QString, QList<Mutation>> m_pending;
+    QHash<QString, QStandardPaths::StandardLocation> m_locations;
+
+    friend class ConfigWriteTask;
+};
+
+}
+
+#endif // CONFIGSYNCER_H
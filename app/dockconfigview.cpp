@@ -130,6 +130,14 @@ void DockConfigView::init()
 
     auto source = QUrl::fromLocalFile(m_dockView->containment()->corona()->kPackage().filePath(tempFilePath));
     setSource(source);
+
+    //! the window follows the size of its contents, it can be shown at once
+    //! and it is resized when the containment layouts have been calculated
+    if (rootObject()) {
+        connect(rootObject(), &QQuickItem::widthChanged, this, &DockConfigView::syncGeometry);
+        connect(rootObject(), &QQuickItem::heightChanged, this, &DockConfigView::syncGeometry);
+    }
+
     syncGeometry();
     syncSlideEffect();
 
@@ -330,7 +338,8 @@ void DockConfigView::hideEvent(QHideEvent *ev)
         }
     }
 
-    deleteLater();
+    //! the window is kept hidden and it is reused the next time the
+    //! settings are shown, the dock deletes it together with itself
 }
 
 void DockConfigView::focusOutEvent(QFocusEvent *ev)
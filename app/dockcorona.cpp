@@ -23,7 +23,11 @@
 #include "packageplugins/shell/dockpackage.h"
 #include "abstractwindowinterface.h"
 #include "alternativeshelper.h"
+#include "configsyncer.h"
+#include "qmlcomponentcache.h"
+#include "screenhotplugcoordinator.h"
 #include "screenpool.h"
+#include "startuptracer.h"
 //dbus adaptor
 #include "lattedockadaptor.h"
 
@@ -36,6 +40,7 @@
 #include <QFile>
 #include <QFontDatabase>
 #include <QQmlContext>
+#include <QTimer>
 
 #include <Plasma>
 #include <Plasma/Corona>
@@ -57,6 +62,9 @@
 
 namespace Latte {
 
+//! the settings windows are compiled when the docks have been loaded
+const int CONFIGVIEWPREWARMDELAY = 10000;
+
 DockCorona::DockCorona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, QObject *parent)
     : Plasma::Corona(parent),
       m_defaultLayoutOnStartup(defaultLayoutOnStartup),
@@ -65,8 +73,11 @@ DockCorona::DockCorona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp,
       m_screenPool(new ScreenPool(KSharedConfig::openConfig(), this)),
       m_globalShortcuts(new GlobalShortcuts(this)),
       m_universalSettings(new UniversalSettings(KSharedConfig::openConfig(), this)),
-      m_layoutManager(new LayoutManager(this))
+      m_layoutManager(new LayoutManager(this)),
+      m_screenHotplugCoordinator(new ScreenHotplugCoordinator(this))
 {
+    StartupSpan span(QStringLiteral("DockCorona::DockCorona"));
+
     setupWaylandIntegration();
 
     KPackage::Package package(new DockPackage(this));
@@ -88,15 +99,23 @@ DockCorona::DockCorona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp,
     qmlRegisterTypes();
     QFontDatabase::addApplicationFont(kPackage().filePath("tangerineFont"));
 
+    //! the dock and its applets are compiled while the layouts are loading
+    m_qmlComponentCache = new QmlComponentCache(this);
+    m_qmlComponentCache->prewarm(QUrl::fromLocalFile(kPackage().filePath("lattedockui")));
+    m_qmlComponentCache->prewarmPackage(QStringLiteral("org.kde.latte.containment"));
+    m_qmlComponentCache->prewarmPackage(QStringLiteral("org.kde.latte.plasmoid"));
+    m_qmlComponentCache->prewarmDiskCache({kPackage().path(),
+                                           QmlComponentCache::appletPackagePath(QStringLiteral("org.kde.latte.containment")),
+                                           QmlComponentCache::appletPackagePath(QStringLiteral("org.kde.latte.plasmoid"))});
+
     if (m_activityConsumer && (m_activityConsumer->serviceStatus() == KActivities::Consumer::Running)) {
         load();
     }
 
     connect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
 
-    m_docksScreenSyncTimer.setSingleShot(true);
-    m_docksScreenSyncTimer.setInterval(2500);
-    connect(&m_docksScreenSyncTimer, &QTimer::timeout, this, &DockCorona::syncDockViewsToScreens);
+    //! the docks are synced to the screens once the screens have settled
+    connect(m_screenHotplugCoordinator, &ScreenHotplugCoordinator::screensSettled, this, &DockCorona::syncDockViewsToScreens);
 
     //! Dbus adaptor initialization
     new LatteDockAdaptor(this);
@@ -106,7 +125,7 @@ DockCorona::DockCorona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp,
 
 DockCorona::~DockCorona()
 {
-    m_docksScreenSyncTimer.stop();
+    disconnect(m_screenHotplugCoordinator, &ScreenHotplugCoordinator::screensSettled, this, &DockCorona::syncDockViewsToScreens);
 
     if (m_layoutManager->memoryUsage() == Dock::SingleLayout) {
         cleanConfig();
@@ -121,20 +140,32 @@ DockCorona::~DockCorona()
     m_screenPool->deleteLater();
     m_universalSettings->deleteLater();
 
+    if (m_qmlComponentCache) {
+        m_qmlComponentCache->deleteLater();
+    }
+
     disconnect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
     delete m_activityConsumer;
 
+    //! everything must be on disk before quitting
+    ConfigSyncer::self()->flush();
+    StartupTracer::self()->finish();
+
     qDebug() << "Latte Corona - deleted...";
 }
 
 void DockCorona::load()
 {
     if (m_activityConsumer && (m_activityConsumer->serviceStatus() == KActivities::Consumer::Running) && m_activitiesStarting) {
+        StartupSpan span(QStringLiteral("DockCorona::load"));
+
         disconnect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
         m_layoutManager->load();
 
         m_activitiesStarting = false;
 
+        QTimer::singleShot(CONFIGVIEWPREWARMDELAY, this, &DockCorona::prewarmConfigView);
+
         //  connect(qGuiApp, &QGuiApplication::screenAdded, this, &DockCorona::addOutput, Qt::UniqueConnection);
         connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &DockCorona::primaryOutputChanged, Qt::UniqueConnection);
         //  connect(qGuiApp, &QGuiApplication::screenRemoved, this, &DockCorona::screenRemoved, Qt::UniqueConnection);
@@ -300,6 +331,11 @@ LayoutManager *DockCorona::layoutManager() const
     return m_layoutManager;
 }
 
+ScreenHotplugCoordinator *DockCorona::screenHotplugCoordinator() const
+{
+    return m_screenHotplugCoordinator;
+}
+
 int DockCorona::numScreens() const
 {
     return qGuiApp->screens().count();
@@ -577,7 +613,7 @@ void DockCorona::screenRemoved(QScreen *screen)
 
 void DockCorona::screenCountChanged()
 {
-    m_docksScreenSyncTimer.start();
+    m_screenHotplugCoordinator->notifyChange();
 }
 
 //! the central functions that updates loading/unloading dockviews
@@ -772,6 +808,10 @@ int DockCorona::screenForContainment(const Plasma::Containment *containment) con
 bool DockCorona::explicitDockOccupyEdge(int screen, Plasma::Types::Location location) const
 {
     foreach (auto containment, containments()) {
+        if (m_layoutManager->isStandbyContainment(containment)) {
+            continue;
+        }
+
         bool onPrimary = containment->config().readEntry("onPrimary", true);
         int id = containment->lastScreen();
         Plasma::Types::Location contLocation = containment->location();
@@ -790,6 +830,16 @@ void DockCorona::recreateDock(Plasma::Containment *containment)
     m_layoutManager->recreateDock(containment);
 }
 
+void DockCorona::prewarmConfigView()
+{
+    //! only the compiled components are kept, each dock still creates its
+    //! own settings windows for its containment when they are requested
+    if (m_qmlComponentCache) {
+        m_qmlComponentCache->prewarm(QUrl::fromLocalFile(kPackage().filePath("lattedockconfigurationui")));
+        m_qmlComponentCache->prewarm(QUrl::fromLocalFile(kPackage().filePath("lattedocksecondaryconfigurationui")));
+    }
+}
+
 void DockCorona::showAlternativesForApplet(Plasma::Applet *applet)
 {
     const QString alternativesQML = kPackage().filePath("appletalternativesui");
@@ -946,6 +996,13 @@ void DockCorona::updateDockItemBadge(QString identifier, QString value)
     m_globalShortcuts->updateDockItemBadge(identifier, value);
 }
 
+//! memory report through dbus interface, e.g. in order to find leaks
+//! after many layout switches
+QString DockCorona::memoryReport()
+{
+    return m_layoutManager->memoryReport();
+}
+
 inline void DockCorona::qmlRegisterTypes() const
 {
     qmlRegisterType<QScreen>();
@@ -57,6 +57,9 @@ class PlasmaShell;
 
 namespace Latte {
 
+class QmlComponentCache;
+class ScreenHotplugCoordinator;
+
 class DockCorona : public Plasma::Corona {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.kde.LatteDock")
@@ -98,6 +101,7 @@ public:
     ScreenPool *screenPool() const;
     UniversalSettings *universalSettings() const;
     LayoutManager *layoutManager() const;
+    ScreenHotplugCoordinator *screenHotplugCoordinator() const;
 
     KWayland::Client::PlasmaShell *waylandDockCoronaInterface() const;
 
@@ -107,6 +111,9 @@ public slots:
     void updateDockItemBadge(QString identifier, QString value);
     void unload();
 
+    //! JSON report of the memory of the layouts, docks and applets
+    QString memoryReport();
+
 signals:
     void configurationShown(PlasmaQuick::ConfigView *configView);
     void docksCountChanged();
@@ -117,6 +124,7 @@ private slots:
     void showAlternativesForApplet(Plasma::Applet *applet);
     void alternativesVisibilityChanged(bool visible);
     void load();
+    void prewarmConfigView();
 
     void addOutput(QScreen *screen);
     void primaryOutputChanged();
@@ -147,8 +155,6 @@ private:
 
     QList<KDeclarative::QmlObject *> m_alternativesObjects;
 
-    QTimer m_docksScreenSyncTimer;
-
     KActivities::Consumer *m_activityConsumer;
     QPointer<KAboutApplicationDialog> aboutDialog;
 
@@ -156,6 +162,8 @@ private:
     GlobalShortcuts *m_globalShortcuts{nullptr};
     UniversalSettings *m_universalSettings{nullptr};
     LayoutManager *m_layoutManager{nullptr};
+    QmlComponentCache *m_qmlComponentCache{nullptr};
+    ScreenHotplugCoordinator *m_screenHotplugCoordinator{nullptr};
 
     KWayland::Client::PlasmaShell *m_waylandDockCorona{nullptr};
 
@@ -21,7 +21,9 @@
 #include "dockview.h"
 #include "dockconfigview.h"
 #include "dockcorona.h"
+#include "memoryaccounting.h"
 #include "panelshadows_p.h"
+#include "screenhotplugcoordinator.h"
 #include "visibilitymanager.h"
 #include "../liblattedock/extras.h"
 
@@ -99,6 +101,7 @@ DockView::DockView(Plasma::Corona *corona, QScreen *targetScreen, bool dockWindo
 
         if (!m_visibility) {
             m_visibility = new VisibilityManager(this);
+            emit visibilityChanged();
         }
 
         QAction *lockWidgetsAction = this->containment()->actions()->action("lock widgets");
@@ -135,7 +138,18 @@ DockView::DockView(Plasma::Corona *corona, QScreen *targetScreen, bool dockWindo
 
     m_screenSyncTimer.setSingleShot(true);
     m_screenSyncTimer.setInterval(2000);
-    connect(&m_screenSyncTimer, &QTimer::timeout, this, &DockView::reconsiderScreen);
+    connect(&m_screenSyncTimer, &QTimer::timeout, this, [&]() {
+        auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
+
+        //! while the screens are changing the dock waits, it is reconsidered
+        //! when the screens settle together with all the other docks
+        if (dockCorona && dockCorona->screenHotplugCoordinator()->isSettling()) {
+            m_screenSyncTimer.start();
+            return;
+        }
+
+        reconsiderScreen();
+    });
 }
 
 DockView::~DockView()
@@ -158,10 +172,12 @@ DockView::~DockView()
 
     if (m_configView) {
         m_configView->setVisible(false);//hide();
+        m_configView->deleteLater();
     }
 
     if (m_secondaryConfigView) {
         m_secondaryConfigView->setVisible(false);
+        m_secondaryConfigView->deleteLater();
     }
 
     if (m_visibility)
@@ -339,6 +355,33 @@ void DockView::disconnectSensitiveSignals()
     }
 }
 
+void DockView::releaseContainment()
+{
+    if (!containment()) {
+        return;
+    }
+
+    if (m_configView) {
+        m_configView->deleteLater();
+    }
+
+    if (m_secondaryConfigView) {
+        m_secondaryConfigView->deleteLater();
+    }
+
+    disconnect(containment(), SIGNAL(statusChanged(Plasma::Types::ItemStatus)), this, SLOT(statusChanged(Plasma::Types::ItemStatus)));
+    setManagedLayout(nullptr);
+
+    //! the visibility manager reads its mode, timers and raise options from the
+    //! containment and it is connected to it, so it is rebuilt for the next one
+    if (m_visibility) {
+        delete m_visibility;
+        emit visibilityChanged();
+    }
+
+    setContainment(nullptr);
+}
+
 void DockView::availableScreenRectChanged()
 {
     if (m_inDelete)
@@ -405,7 +448,7 @@ bool DockView::setCurrentScreen(const QString id)
 
                 //! asynchronous call in order to not crash from configwindow
                 //! deletion from sliding out animation
-                QTimer::singleShot(100, [this]() {
+                QTimer::singleShot(100, this, [this]() {
                     emit hideDockDuringScreenChangeStarted();
                 });
             }
@@ -587,7 +630,7 @@ void DockView::setConfigWindowsSticker(bool sticker)
 
 bool DockView::settingsWindowIsShown() const
 {
-    return (m_configView != nullptr);
+    return (m_configView && m_configView->isVisible());
 }
 
 bool DockView::settingsWindowsAreActive() const
@@ -631,6 +674,8 @@ void DockView::showConfigurationInterfaceForConfigView(PlasmaQuick::ConfigView *
 
     Plasma::Containment *c = qobject_cast<Plasma::Containment *>(applet);
 
+    //! the dock settings windows are kept hidden when they are closed, so
+    //! they are only created the first time
     if (configView && c && c->isContainment() && c == this->containment()) {
         if (configView->isVisible()) {
             configView->setVisible(false);
@@ -652,50 +697,46 @@ void DockView::showConfigurationInterfaceForConfigView(PlasmaQuick::ConfigView *
 
     //! The settings window isnt shown
 
-    bool delayConfigView = false;
-
     if (c && containment() && c->isContainment() && c->id() == this->containment()->id()) {
         if (configType == DockConfigView::PrimaryConfig) {
-            DockConfigView *dockConfigView = new DockConfigView(c, this, DockConfigView::PrimaryConfig);
-            configView = new DockConfigView(c, this);
+            configView = new DockConfigView(c, this, DockConfigView::PrimaryConfig);
             m_configView = configView;
 
             if (m_secondaryConfigView) {
                 connect(m_configView, &QObject::destroyed, m_secondaryConfigView, &QObject::deleteLater);
                 connect(m_secondaryConfigView, &QObject::destroyed, m_configView, &QObject::deleteLater);
+
+                //! the kept windows are also hidden together
+                auto primaryConfigView = static_cast<DockConfigView *>(m_configView.data());
+                auto secondaryConfigView = static_cast<DockConfigView *>(m_secondaryConfigView.data());
+
+                connect(primaryConfigView, &QWindow::visibleChanged, secondaryConfigView, [secondaryConfigView](bool visible) {
+                    if (!visible && secondaryConfigView->isVisible()) {
+                        secondaryConfigView->hideConfigWindow();
+                    }
+                });
+                connect(secondaryConfigView, &QWindow::visibleChanged, primaryConfigView, [primaryConfigView](bool visible) {
+                    if (!visible && primaryConfigView->isVisible()) {
+                        primaryConfigView->hideConfigWindow();
+                    }
+                });
             }
         } else {
             DockConfigView *dockConfigView = new DockConfigView(c, this, DockConfigView::SecondaryConfig);
             configView = static_cast<PlasmaQuick::ConfigView *>(dockConfigView);
             m_secondaryConfigView = configView;
         }
-
-        delayConfigView = true;
     } else {
         configView = new PlasmaQuick::ConfigView(applet);
         m_configView = configView;
     }
 
-    if (configView) {
-        configView->init();
-        applyActivitiesToWindows();
-    }
+    configView->init();
+    applyActivitiesToWindows();
 
-    if (!delayConfigView) {
-        configView->setVisible(true);
-        //m_configView.data()->show();
-    } else {
-        //add a timer for showing the configuration window the first time it is
-        //created in order to give the containmnent's layouts the time to
-        //calculate the window's height
-        if (!KWindowSystem::isPlatformWayland()) {
-            QTimer::singleShot(150, configView, SLOT(show()));
-        } else {
-            QTimer::singleShot(150, [this, configView]() {
-                configView->setVisible(true);
-            });
-        }
-    }
+    //! the settings windows follow the size of their contents, so they are
+    //! shown at once instead of waiting for the containment layouts
+    configView->setVisible(true);
 }
 
 
@@ -1063,6 +1104,11 @@ int DockView::docksWithTasks()
     return dockCorona->noDocksWithTasks();
 }
 
+QVariantMap DockView::memoryReport()
+{
+    return MemoryAccounting::dockViewReport(this);
+}
+
 void DockView::updateFormFactor()
 {
     if (!this->containment())
@@ -1407,7 +1453,7 @@ void DockView::setManagedLayout(Layout *layout)
     if (m_managedLayout) {
         //! Sometimes the activity isnt completely ready, by adding a delay
         //! we try to catch up
-        QTimer::singleShot(100, [this]() {
+        QTimer::singleShot(100, this, [this]() {
             if (m_managedLayout) {
                 qDebug() << "DOCK VIEW FROM LAYOUT ::: " << m_managedLayout->name() << " - activities: " << m_managedLayout->appliedActivities();
                 applyActivitiesToWindows();
@@ -1474,10 +1520,15 @@ void DockView::moveToLayout(QString layoutName)
         return;
     }
 
-    QList<Plasma::Containment *> containments = m_managedLayout->unassignFromLayout(this);
-
     DockCorona *dockCorona = qobject_cast<DockCorona *>(this->corona());
 
+    //! the target layout must have its containments before a dock is added to it
+    if (dockCorona) {
+        dockCorona->layoutManager()->materializeLayout(layoutName);
+    }
+
+    QList<Plasma::Containment *> containments = m_managedLayout->unassignFromLayout(this);
+
     if (dockCorona && containments.size() > 0) {
         Layout *newLayout = dockCorona->layoutManager()->activeLayout(layoutName);
 
@@ -2349,7 +2400,7 @@ void DockView::saveConfig()
     auto config = this->containment()->config();
     config.writeEntry("onPrimary", m_onPrimary);
     config.writeEntry("dockWindowBehavior", m_dockWinBehavior);
-    config.sync();
+    this->containment()->configNeedsSaving();
 }
 
 void DockView::restoreConfig()
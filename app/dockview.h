@@ -188,6 +188,10 @@ public:
     //! when its containment is destroyed
     void disconnectSensitiveSignals();
 
+    //! the dock view is detached from its containment in order to be
+    //! reused for a similar dock of the layout that is loaded next
+    void releaseContainment();
+
 public slots:
     Q_INVOKABLE void addNewDock();
     Q_INVOKABLE void removeDock();
@@ -208,6 +212,9 @@ public slots:
 
     Q_INVOKABLE int docksWithTasks();
 
+    //! estimated memory of the dock and its applets, it is shown in the debug window
+    Q_INVOKABLE QVariantMap memoryReport();
+
     Q_INVOKABLE bool mimeContainsPlasmoid(QMimeData *mimeData, QString name);
     Q_INVOKABLE bool setCurrentScreen(const QString id);
     Q_INVOKABLE bool tasksPresent();
@@ -27,6 +27,7 @@
 #include <QX11Info>
 
 #include <KActionCollection>
+#include <KActivities/Consumer>
 #include <KGlobalAccel>
 #include <KLocalizedString>
 #include <KPluginMetaData>
@@ -159,6 +160,8 @@ GlobalShortcuts::GlobalShortcuts(QObject *parent)
     }
 
     connect(&m_hideDockTimer, &QTimer::timeout, this, &GlobalShortcuts::hideDockTimerSlot);
+
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &GlobalShortcuts::invalidateTasksRoutes);
 }
 
 GlobalShortcuts::~GlobalShortcuts()
@@ -167,6 +170,27 @@ GlobalShortcuts::~GlobalShortcuts()
 
 void GlobalShortcuts::init()
 {
+    //! tasks routes must be rebuilt when docks and applets change
+    connect(m_corona, &DockCorona::docksCountChanged, this, &GlobalShortcuts::invalidateTasksRoutes);
+    connect(m_corona, &Plasma::Corona::containmentAdded, this, [this](Plasma::Containment * containment) {
+        invalidateTasksRoutes();
+
+        //! an added applet is checked again even if it was found non routable
+        connect(containment, &Plasma::Containment::appletAdded, this, [this](Plasma::Applet * applet) {
+            m_nonRoutableApplets.remove(applet);
+            invalidateTasksRoutes();
+        });
+        connect(containment, &Plasma::Containment::appletRemoved, this, [this](Plasma::Applet * applet) {
+            m_nonRoutableApplets.remove(applet);
+            invalidateTasksRoutes();
+        });
+        connect(containment, &QObject::destroyed, this, &GlobalShortcuts::invalidateTasksRoutes);
+    });
+
+    //! the current docks change with the activity in multiple layouts mode
+    connect(m_corona->activitiesConsumer(), &KActivities::Consumer::currentActivityChanged,
+            this, &GlobalShortcuts::invalidateTasksRoutes);
+
     KActionCollection *generalActions = new KActionCollection(m_corona);
 
     //show-hide the main dock in the primary screen
@@ -273,145 +297,182 @@ void GlobalShortcuts::activateLauncherMenu()
 }
 
 
-//! Activate task manager entry
-void GlobalShortcuts::activateTaskManagerEntry(int index, Qt::Key modifier)
+void GlobalShortcuts::invalidateTasksRoutes()
 {
-    m_lastInvokedAction = dynamic_cast<QAction *>(sender());
+    m_tasksRoutesDirty = true;
+}
 
-    auto activateTaskManagerEntryOnContainment = [this](const Plasma::Containment * c, int index, Qt::Key modifier) {
-        const auto &applets = c->applets();
+void GlobalShortcuts::updateTasksRoutes()
+{
+    m_actionRoutes.clear();
+    m_badgeRoutes.clear();
+    m_tasksRoutesDirty = false;
 
-        for (auto *applet : applets) {
-            const auto &provides = KPluginMetaData::readStringList(applet->pluginMetaData().rawData(), QStringLiteral("X-Plasma-Provides"));
+    //! the layout manager is created after the global shortcuts
+    LayoutManager *layoutManager = m_corona->layoutManager();
+    connect(layoutManager, &LayoutManager::currentLayoutNameChanged,
+            this, &GlobalShortcuts::invalidateTasksRoutes, Qt::UniqueConnection);
+    connect(layoutManager, &LayoutManager::activeLayoutsChanged,
+            this, &GlobalShortcuts::invalidateTasksRoutes, Qt::UniqueConnection);
 
-            if (provides.contains(QLatin1String("org.kde.plasma.multitasking"))) {
-                if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                    const auto &childItems = appletInterface->childItems();
+    QList<TasksRoute> primaryRoutes;
+    QList<TasksRoute> secondaryRoutes;
 
-                    if (childItems.isEmpty()) {
-                        continue;
-                    }
+    QHash<const Plasma::Containment *, DockView *> *views =  layoutManager->currentDockViews();
 
-                    KPluginMetaData meta = applet->kPackage().metadata();
+    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
+        DockView *view = it.value();
+        connect(view, &QWindow::screenChanged, this, &GlobalShortcuts::invalidateTasksRoutes, Qt::UniqueConnection);
 
-                    for (QQuickItem *item : childItems) {
-                        if (auto *metaObject = item->metaObject()) {
-                            // not using QMetaObject::invokeMethod to avoid warnings when calling
-                            // this on applets that don't have it or other child items since this
-                            // is pretty much trial and error.
+        const auto &applets = it.key()->applets();
 
-                            // Also, "var" arguments are treated as QVariant in QMetaObject
-                            int methodIndex = modifier == static_cast<Qt::Key>(Qt::META) ?
-                                              metaObject->indexOfMethod("activateTaskAtIndex(QVariant)") :
-                                              metaObject->indexOfMethod("newInstanceForTaskAtIndex(QVariant)");
+        for (auto *applet : applets) {
+            const auto &provides = KPluginMetaData::readStringList(applet->pluginMetaData().rawData(), QStringLiteral("X-Plasma-Provides"));
+            bool isLattePlasmoid = (applet->pluginMetaData().pluginId() == QLatin1String("org.kde.latte.plasmoid"));
 
-                            int methodIndex2 = metaObject->indexOfMethod("setShowTasksNumbers(QVariant)");
+            if (m_nonRoutableApplets.contains(applet)
+                || (!isLattePlasmoid && !provides.contains(QLatin1String("org.kde.plasma.multitasking")))) {
+                continue;
+            }
 
-                            if (methodIndex == -1 || (methodIndex2 == -1 && meta.pluginId() == "org.kde.latte.plasmoid")) {
-                                continue;
-                            }
+            QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>();
 
-                            m_tasksPlasmoid = item;
-                            m_tasksMethodIndex = methodIndex2;
-                            m_methodShowNumbers = metaObject->method(m_tasksMethodIndex);
+            if (!appletInterface) {
+                //! the applet has not been created yet, the routes are rebuilt
+                //! lazily after its appletAdded signal
+                continue;
+            }
 
-                            QMetaMethod method = metaObject->method(methodIndex);
+            bool routeFound{false};
 
-                            if (method.invoke(item, Q_ARG(QVariant, index))) {
-                                if (methodIndex2 != -1) {
-                                    m_methodShowNumbers.invoke(item, Q_ARG(QVariant, true));
-                                }
+            for (QQuickItem *item : appletInterface->childItems()) {
+                if (auto *metaObject = item->metaObject()) {
+                    // "var" arguments are treated as QVariant in QMetaObject
+                    int activateIndex = metaObject->indexOfMethod("activateTaskAtIndex(QVariant)");
+                    int badgeIndex = metaObject->indexOfMethod("updateBadge(QVariant,QVariant)");
 
-                                return true;
-                            }
-                        }
+                    if (activateIndex == -1 && badgeIndex == -1) {
+                        continue;
+                    }
+
+                    TasksRoute route;
+                    route.view = view;
+                    route.item = item;
+                    route.isLattePlasmoid = isLattePlasmoid;
+                    route.activateTask = metaObject->method(activateIndex);
+                    route.newInstanceForTask = metaObject->method(metaObject->indexOfMethod("newInstanceForTaskAtIndex(QVariant)"));
+                    route.showTasksNumbers = metaObject->method(metaObject->indexOfMethod("setShowTasksNumbers(QVariant)"));
+                    route.updateBadge = metaObject->method(badgeIndex);
+
+                    connect(item, &QObject::destroyed, this, &GlobalShortcuts::invalidateTasksRoutes, Qt::UniqueConnection);
+
+                    if (view->screen() == qGuiApp->primaryScreen()) {
+                        primaryRoutes.append(route);
+                    } else {
+                        secondaryRoutes.append(route);
                     }
+
+                    routeFound = true;
+                    break;
                 }
             }
-        }
-
-        return false;
-    };
 
-    QHash<const Plasma::Containment *, DockView *> *views =  m_corona->layoutManager()->currentDockViews();
+            if (!routeFound) {
+                //! a multitasking applet without the route methods, it is not
+                //! checked again on every press
+                m_nonRoutableApplets.insert(applet);
+            }
+        }
+    }
 
     // To avoid overly complex configuration, we'll try to get the 90% usecase to work
-    // which is activating a task on the task manager on a panel on the primary screen.
-    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
-        if (it.value()->screen() != qGuiApp->primaryScreen()) {
-            continue;
+    // which is the task manager on a panel on the primary screen. If we didn't find
+    // anything on primary, the panels on the other screens are used.
+    for (const auto &route : primaryRoutes + secondaryRoutes) {
+        //! the Latte plasmoid shows the task numbers for the shortcuts
+        bool canShowNumbers = !route.isLattePlasmoid || route.showTasksNumbers.isValid();
+
+        if (route.activateTask.isValid() && canShowNumbers && !m_actionRoutes.contains(ActivateTaskAction)) {
+            m_actionRoutes[ActivateTaskAction] = route;
         }
 
-        if (activateTaskManagerEntryOnContainment(it.key(), index, modifier)) {
-            m_hideDock = it.value();
-            m_hideDock->visibility()->setBlockHiding(true);
-            m_hideDockTimer.start();
-            return;
+        if (route.newInstanceForTask.isValid() && canShowNumbers && !m_actionRoutes.contains(NewInstanceForTaskAction)) {
+            m_actionRoutes[NewInstanceForTaskAction] = route;
         }
-    }
 
-    // we didn't find anything on primary, try all the panels
-    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
-        if (activateTaskManagerEntryOnContainment(it.key(), index, modifier)) {
-            m_hideDock = it.value();
-            m_hideDock->visibility()->setBlockHiding(true);
-            m_hideDockTimer.start();
-            return;
+        if (route.isLattePlasmoid && route.showTasksNumbers.isValid() && !m_actionRoutes.contains(ShowTasksNumbersAction)) {
+            m_actionRoutes[ShowTasksNumbersAction] = route;
+        }
+
+        if (route.isLattePlasmoid && route.updateBadge.isValid()) {
+            m_badgeRoutes.append(route);
         }
     }
 }
 
-//! update badge for specific dock item
-void GlobalShortcuts::updateDockItemBadge(QString identifier, QString value)
+const GlobalShortcuts::TasksRoute *GlobalShortcuts::tasksRoute(TasksAction action)
 {
-    //qDebug() << "DBUS CALL ::: " << identifier << " - " << value;
-    auto updateBadgeForTaskInContainment = [this](const Plasma::Containment * c, QString identifier, QString value) {
-        const auto &applets = c->applets();
+    if (m_tasksRoutesDirty) {
+        updateTasksRoutes();
+    }
 
-        for (auto *applet : applets) {
-            KPluginMetaData meta = applet->kPackage().metadata();
+    auto it = m_actionRoutes.constFind(action);
 
-            if (meta.pluginId() == "org.kde.latte.plasmoid") {
+    if (it == m_actionRoutes.constEnd() || !it->view || !it->item) {
+        return nullptr;
+    }
 
-                if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                    const auto &childItems = appletInterface->childItems();
+    return &(*it);
+}
 
-                    if (childItems.isEmpty()) {
-                        continue;
-                    }
+const QList<GlobalShortcuts::TasksRoute> &GlobalShortcuts::badgeRoutes()
+{
+    if (m_tasksRoutesDirty) {
+        updateTasksRoutes();
+    }
 
-                    for (QQuickItem *item : childItems) {
-                        if (auto *metaObject = item->metaObject()) {
-                            // not using QMetaObject::invokeMethod to avoid warnings when calling
-                            // this on applets that don't have it or other child items since this
-                            // is pretty much trial and error.
-                            // Also, "var" arguments are treated as QVariant in QMetaObject
+    return m_badgeRoutes;
+}
 
-                            int methodIndex = metaObject->indexOfMethod("updateBadge(QVariant,QVariant)");
+//! Activate task manager entry
+void GlobalShortcuts::activateTaskManagerEntry(int index, Qt::Key modifier)
+{
+    m_lastInvokedAction = dynamic_cast<QAction *>(sender());
 
-                            if (methodIndex == -1) {
-                                continue;
-                            }
+    bool activate = (modifier == static_cast<Qt::Key>(Qt::META));
+    const TasksRoute *route = tasksRoute(activate ? ActivateTaskAction : NewInstanceForTaskAction);
 
-                            QMetaMethod method = metaObject->method(methodIndex);
+    if (!route) {
+        return;
+    }
 
-                            if (method.invoke(item, Q_ARG(QVariant, identifier), Q_ARG(QVariant, value))) {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
+    const QMetaMethod &method = activate ? route->activateTask : route->newInstanceForTask;
+
+    m_tasksPlasmoid = route->item;
+    m_tasksMethodIndex = route->showTasksNumbers.methodIndex();
+    m_methodShowNumbers = route->showTasksNumbers;
+
+    if (method.invoke(route->item, Q_ARG(QVariant, index))) {
+        if (m_methodShowNumbers.isValid()) {
+            m_methodShowNumbers.invoke(route->item, Q_ARG(QVariant, true));
         }
 
-        return false;
-    };
+        m_hideDock = route->view;
+        m_hideDock->visibility()->setBlockHiding(true);
+        m_hideDockTimer.start();
+    }
+}
 
-    QHash<const Plasma::Containment *, DockView *> *views =  m_corona->layoutManager()->currentDockViews();
+//! update badge for specific dock item
+void GlobalShortcuts::updateDockItemBadge(QString identifier, QString value)
+{
+    //qDebug() << "DBUS CALL ::: " << identifier << " - " << value;
 
     // update badges in all Latte Tasks plasmoids
-    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
-        updateBadgeForTaskInContainment(it.key(), identifier, value);
+    for (const auto &route : badgeRoutes()) {
+        if (route.item) {
+            route.updateBadge.invoke(route.item, Q_ARG(QVariant, identifier), Q_ARG(QVariant, value));
+        }
     }
 }
 
@@ -419,74 +480,21 @@ void GlobalShortcuts::showDock()
 {
     m_lastInvokedAction = dynamic_cast<QAction *>(sender());
 
-    auto containsLattePlasmoid = [this](const Plasma::Containment * c) {
-        const auto &applets = c->applets();
-
-        for (auto *applet : applets) {
-            KPluginMetaData meta = applet->kPackage().metadata();
-
-            if (meta.pluginId() == "org.kde.latte.plasmoid") {
-                if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                    const auto &childItems = appletInterface->childItems();
-
-                    if (childItems.isEmpty()) {
-                        continue;
-                    }
+    //! the task numbers are shown on a dock on the primary screen when possible
+    const TasksRoute *route = tasksRoute(ShowTasksNumbersAction);
 
-                    for (QQuickItem *item : childItems) {
-                        if (auto *metaObject = item->metaObject()) {
-                            // not using QMetaObject::invokeMethod to avoid warnings when calling
-                            // this on applets that don't have it or other child items since this
-                            // is pretty much trial and error.
-
-                            // Also, "var" arguments are treated as QVariant in QMetaObject
-                            int methodIndex2 = metaObject->indexOfMethod("setShowTasksNumbers(QVariant)");
-
-                            if (methodIndex2 == -1) {
-                                continue;
-                            }
-
-                            m_tasksPlasmoid = item;
-                            m_tasksMethodIndex = methodIndex2;
-                            m_methodShowNumbers = metaObject->method(m_tasksMethodIndex);
-
-                            if (m_methodShowNumbers.invoke(item, Q_ARG(QVariant, true))) {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        return false;
-    };
-
-    QHash<const Plasma::Containment *, DockView *> *views =  m_corona->layoutManager()->currentDockViews();
-
-    // To avoid overly complex configuration, we'll try to get the 90% usecase to work
-    // which is activating a task on the task manager on a panel on the primary screen.
-    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
-        if (it.value()->screen() != qGuiApp->primaryScreen()) {
-            continue;
-        }
-
-        if (containsLattePlasmoid(it.key())) {
-            m_hideDock = it.value();
-            m_hideDock->visibility()->setBlockHiding(true);
-            m_hideDockTimer.start();
-            return;
-        }
+    if (!route) {
+        return;
     }
 
-    // we didn't find anything on primary, try all the panels
-    for (auto it = views->constBegin(), end = views->constEnd(); it != end; ++it) {
-        if (containsLattePlasmoid(it.key())) {
-            m_hideDock = it.value();
-            m_hideDock->visibility()->setBlockHiding(true);
-            m_hideDockTimer.start();
-            return;
-        }
+    m_tasksPlasmoid = route->item;
+    m_tasksMethodIndex = route->showTasksNumbers.methodIndex();
+    m_methodShowNumbers = route->showTasksNumbers;
+
+    if (m_methodShowNumbers.invoke(route->item, Q_ARG(QVariant, true))) {
+        m_hideDock = route->view;
+        m_hideDock->visibility()->setBlockHiding(true);
+        m_hideDockTimer.start();
     }
 }
 
@@ -25,8 +25,11 @@
 #include "dockview.h"
 #include "../liblattedock/dock.h"
 
+#include <QHash>
 #include <QQuickItem>
 #include <QMetaMethod>
+#include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 class DockCorona;
@@ -46,9 +49,35 @@ public:
 
 private slots:
     void hideDockTimerSlot();
+    void invalidateTasksRoutes();
 
 private:
+    //! the shortcut actions that are delivered to a single tasks plasmoid
+    enum TasksAction {
+        ActivateTaskAction = 0,
+        NewInstanceForTaskAction,
+        ShowTasksNumbersAction
+    };
+
+    //! a tasks plasmoid found in the current docks with its methods already
+    //! resolved, the routes are rebuilt only when docks, applets, layouts
+    //! or the current activity change
+    struct TasksRoute {
+        QPointer<DockView> view;
+        QPointer<QQuickItem> item;
+        bool isLattePlasmoid{false};
+        QMetaMethod activateTask;
+        QMetaMethod newInstanceForTask;
+        QMetaMethod showTasksNumbers;
+        QMetaMethod updateBadge;
+    };
+
     void init();
+    void updateTasksRoutes();
+    //! the plasmoid that receives the action, nullptr when there is none
+    const TasksRoute *tasksRoute(TasksAction action);
+    //! the Latte plasmoids that receive the badges
+    const QList<TasksRoute> &badgeRoutes();
     void activateTaskManagerEntry(int index, Qt::Key modifier);
     void showDock();
     void hideDock();
@@ -66,6 +95,13 @@ private:
     QQuickItem *m_tasksPlasmoid{nullptr};
     QMetaMethod m_methodShowNumbers;
 
+    bool m_tasksRoutesDirty{true};
+    //! the first plasmoid that supports each action, docks in the primary
+    //! screen are preferred
+    QHash<int, TasksRoute> m_actionRoutes;
+    QList<TasksRoute> m_badgeRoutes;
+    QSet<const Plasma::Applet *> m_nonRoutableApplets;
+
     DockCorona *m_corona{nullptr};
 };
 
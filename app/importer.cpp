@@ -20,8 +20,11 @@
 
 #include "importer.h"
 
+#include "archiveinspector.h"
+#include "configsyncer.h"
 #include "layoutmanager.h"
 #include "layout.h"
+#include "layoutpack.h"
 #include "screenpool.h"
 #include "../liblattedock/dock.h"
 
@@ -29,8 +32,6 @@
 #include <QTemporaryDir>
 
 #include <KArchive/KTar>
-#include <KArchive/KArchiveEntry>
-#include <KArchive/KArchiveDirectory>
 #include <KConfigGroup>
 #include <KLocalizedString>
 #include <KNotification>
@@ -241,42 +242,24 @@ bool Importer::importOldConfiguration(QString oldConfigPath, QString newName)
         return false;
     }
 
-    KTar archive(oldConfigPath, QStringLiteral("application/x-tar"));
-    archive.open(QIODevice::ReadOnly);
+    //! the archive structure is validated before anything is extracted
+    ArchiveInspector inspector(oldConfigPath);
 
-    if (!archive.isOpen()) {
+    if (inspector.version() != ConfigVersion1) {
+        qInfo() << i18nc("import/export config", "The file has a wrong format!!!");
         return false;
     }
 
-    auto rootDir = archive.directory();
     QTemporaryDir uniqueTempDir;
     QDir tempDir{uniqueTempDir.path()};
 
     qDebug() << "temp layout directory : " << tempDir.absolutePath();
 
-    if (rootDir) {
-        if (!tempDir.exists())
-            tempDir.mkpath(tempDir.absolutePath());
+    if (!tempDir.exists())
+        tempDir.mkpath(tempDir.absolutePath());
 
-        foreach (auto &name, rootDir->entries()) {
-            auto fileEntry = rootDir->file(name);
-
-            if (fileEntry && (fileEntry->name() == "lattedockrc"
-                              || fileEntry->name() == "lattedock-appletsrc")) {
-                if (!fileEntry->copyTo(tempDir.absolutePath())) {
-                    qInfo() << i18nc("import/export config", "The extracted file could not be copied!!!");
-                    archive.close();
-                    return false;
-                }
-            } else {
-                qInfo() << i18nc("import/export config", "The file has a wrong format!!!");
-                archive.close();
-                return false;
-            }
-        }
-    } else {
-        qInfo() << i18nc("import/export config", "The temp directory could not be created!!!");
-        archive.close();
+    if (!inspector.extractFilesTo({"lattedockrc", "lattedock-appletsrc"}, tempDir.absolutePath())) {
+        qInfo() << i18nc("import/export config", "The extracted file could not be copied!!!");
         return false;
     }
 
@@ -320,6 +303,8 @@ bool Importer::importOldConfiguration(QString oldConfigPath, QString newName)
 
 bool Importer::exportFullConfiguration(QString file)
 {
+    ConfigSyncer::self()->flush();
+
     if (QFile::exists(file) && !QFile::remove(file)) {
         return false;
     }
@@ -354,88 +339,27 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
             return Importer::UnknownFileType;
     }
 
-    if (!file.endsWith(".latterc")) {
-        return Importer::UnknownFileType;
+    if (file.endsWith(".lattepack")) {
+        return LayoutPack::isValid(file) ? Importer::LayoutsPackVersion1 : Importer::UnknownFileType;
     }
 
-    KTar archive(file, QStringLiteral("application/x-tar"));
-    archive.open(QIODevice::ReadOnly);
-
-    //! if the file isnt a tar archive
-    if (!archive.isOpen()) {
+    if (!file.endsWith(".latterc")) {
         return Importer::UnknownFileType;
     }
 
-    QTemporaryDir archiveTempDir;
-
-    bool version1rc = false;
-    bool version1applets = false;
-
-    bool version2rc = false;
-    bool version2LatteDir = false;
-    bool version2layout = false;
-
-    archive.directory()->copyTo(archiveTempDir.path());
-
-
-    //rc file
-    QString rcFile(archiveTempDir.path() + "/lattedockrc");
-
-    if (QFile(rcFile).exists()) {
-        KSharedConfigPtr lConfig = KSharedConfig::openConfig(rcFile);
-        KConfigGroup universalGroup = KConfigGroup(lConfig, "UniversalSettings");
-        int version = universalGroup.readEntry("version", 1);
-
-        if (version == 1) {
-            version1rc = true;
-        } else if (version == 2) {
-            version2rc = true;
-        }
-    }
-
-    //applets file
-    QString appletsFile(archiveTempDir.path() + "/lattedock-appletsrc");
-
-    if (QFile(appletsFile).exists() && version1rc) {
-        KSharedConfigPtr lConfig = KSharedConfig::openConfig(appletsFile);
-        KConfigGroup generalGroup = KConfigGroup(lConfig, "LayoutSettings");
-        int version = generalGroup.readEntry("version", 1);
-
-        if (version == 1) {
-            version1applets = true;
-        } else if (version == 2) {
-            version2layout = true;
-        }
-    }
-
-    //latte directory
-    QString latteDir(archiveTempDir.path() + "/latte");
-
-    if (QDir(latteDir).exists()) {
-        version2LatteDir = true;
-    }
-
-    if (version1applets && version1applets) {
-        return ConfigVersion1;
-    } else if (version2rc && version2LatteDir) {
-        return ConfigVersion2;
-    }
-
-    return Importer::UnknownFileType;
+    //! only the headers and the rc files of the archive are read in memory
+    return ArchiveInspector(file).version();
 }
 
 bool Importer::importHelper(QString fileName)
 {
-    LatteFileVersion version = fileVersion(fileName);
-
-    if ((version != ConfigVersion1) && (version != ConfigVersion2)) {
-        return false;
-    }
+    ConfigSyncer::self()->flush();
 
-    KTar archive(fileName, QStringLiteral("application/x-tar"));
-    archive.open(QIODevice::ReadOnly);
+    //! the archive is inspected and then extracted once from the same instance
+    ArchiveInspector inspector(fileName);
+    LatteFileVersion version = inspector.version();
 
-    if (!archive.isOpen()) {
+    if ((version != ConfigVersion1) && (version != ConfigVersion2)) {
         return false;
     }
 
@@ -446,15 +370,28 @@ bool Importer::importHelper(QString fileName)
         latteDir.removeRecursively();
     }
 
-    archive.directory()->copyTo(QString(QDir::homePath() + "/.config"));
-
-    return true;
+    return inspector.extractTo(QString(QDir::homePath() + "/.config"));
 }
 
 QString Importer::importLayoutHelper(QString fileName)
 {
+    ConfigSyncer::self()->flush();
+
     LatteFileVersion version = fileVersion(fileName);
 
+    if (version == LayoutsPackVersion1) {
+        QStringList files = LayoutPack::extractLayouts(fileName, QDir::homePath() + "/.config/latte");
+
+        if (!files.isEmpty()) {
+            return Layout::layoutName(files.first());
+        }
+
+        //! the identical layouts of the package are already present
+        QStringList names = LayoutPack::layoutNames(fileName);
+
+        return (!names.isEmpty() && layoutExists(names.first())) ? names.first() : QString();
+    }
+
     if (version != LayoutVersion2) {
         return QString();
     }
@@ -530,6 +467,8 @@ QString Importer::uniqueLayoutName(QString name)
 
 QStringList Importer::checkRepairMultipleLayoutsLinkedFile()
 {
+    ConfigSyncer::self()->flush();
+
     QString linkedFilePath = QDir::homePath() + "/.config/latte/" + Layout::MultipleLayoutsName + ".layout.latte";
     KSharedConfigPtr filePtr = KSharedConfig::openConfig(linkedFilePath);
     KConfigGroup linkedContainments = KConfigGroup(filePtr, "Containments");
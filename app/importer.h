@@ -40,7 +40,8 @@ public:
         LayoutVersion1 = 0,
         ConfigVersion1 = 1,
         LayoutVersion2 = 2,
-        ConfigVersion2 = 3
+        ConfigVersion2 = 3,
+        LayoutsPackVersion1 = 4
     };
     Q_ENUM(LatteFileVersion);
 
@@ -70,7 +71,8 @@ public:
     //! check if this layout exists already in the latte directory
     static bool layoutExists(QString layoutName);
     //! imports the specific layout and return the new layout name.
-    //! if the function didnt succeed return an empty string
+    //! if the function didnt succeed return an empty string. For a layouts
+    //! package the first of its layouts is returned
     static QString importLayoutHelper(QString fileName);
 
     //! return the file path of a layout either existing or not
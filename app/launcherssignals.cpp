@@ -22,111 +22,104 @@
 
 namespace Latte {
 
+namespace {
+//! the plasmoid functions that receive each operation, same order as Operation
+const char *endpointMethods[] = {
+    "extSignalAddLauncher(QVariant,QVariant)",
+    "extSignalRemoveLauncher(QVariant,QVariant)",
+    "extSignalAddLauncherToActivity(QVariant,QVariant,QVariant)",
+    "extSignalRemoveLauncherFromActivity(QVariant,QVariant,QVariant)",
+    "extSignalUrlsDropped(QVariant,QVariant)",
+    "extSignalMoveTask(QVariant,QVariant,QVariant)",
+    "extSignalInternalSeparators(QVariant,QVariant,QVariant)"
+};
+}
+
 LaunchersSignals::LaunchersSignals(QObject *parent)
     : QObject(parent)
 {
     m_manager = qobject_cast<LayoutManager *>(parent);
+
+    m_deliveryTimer.setSingleShot(true);
+    m_deliveryTimer.setInterval(0);
+    connect(&m_deliveryTimer, &QTimer::timeout, this, &LaunchersSignals::deliverMessages);
 }
 
 LaunchersSignals::~LaunchersSignals()
 {
 }
 
-QList<Plasma::Applet *> LaunchersSignals::lattePlasmoids(QString layoutName)
+void LaunchersSignals::registerEndpoint(QString layoutName, int appletId, QQuickItem *plasmoid)
 {
-    QList<Plasma::Applet *> applets;
-
-    Layout *layout = m_manager->activeLayout(layoutName);
-    QList<Plasma::Containment *> containments;
-
-    if (layoutName.isEmpty()) {
-        containments = m_manager->corona()->containments();
-    } else if (layout) {
-        containments = *(layout->containments());
+    if (!plasmoid) {
+        return;
     }
 
-    foreach (auto containment, containments) {
-        for (auto *applet : containment->applets()) {
-            KPluginMetaData meta = applet->kPackage().metadata();
+    if (m_endpoints.contains(plasmoid)) {
+        Endpoint &endpoint = m_endpoints[plasmoid];
 
-            if (meta.pluginId() == "org.kde.latte.plasmoid") {
-                applets.append(applet);
-            }
+        if (endpoint.layoutName != layoutName) {
+            removeFromLayoutIndex(plasmoid, endpoint.layoutName);
+            endpoint.layoutName = layoutName;
+            m_layoutEndpoints[layoutName].append(plasmoid);
         }
-    }
-
-    return applets;
-}
-
-void LaunchersSignals::addLauncher(QString layoutName, int launcherGroup, QString launcher)
-{
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
 
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
+        endpoint.appletId = appletId;
         return;
     }
 
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
-
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
+    Endpoint endpoint;
+    endpoint.item = plasmoid;
+    endpoint.appletId = appletId;
+    endpoint.layoutName = layoutName;
 
-            if (childItems.isEmpty()) {
-                continue;
-            }
+    const QMetaObject *metaObject = plasmoid->metaObject();
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalAddLauncher(QVariant,QVariant)");
+    for (int i = 0; i < OperationsCount; ++i) {
+        int methodIndex = metaObject->indexOfMethod(endpointMethods[i]);
 
-                    if (methodIndex == -1) {
-                        continue;
-                    }
-
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
-                }
-            }
+        if (methodIndex != -1) {
+            endpoint.methods[i] = metaObject->method(methodIndex);
         }
     }
+
+    m_endpoints[plasmoid] = endpoint;
+    m_layoutEndpoints[layoutName].append(plasmoid);
+
+    connect(plasmoid, &QObject::destroyed, this, [this](QObject * obj) {
+        unregisterEndpoint(static_cast<QQuickItem *>(obj));
+    });
 }
 
-void LaunchersSignals::removeLauncher(QString layoutName, int launcherGroup, QString launcher)
+void LaunchersSignals::unregisterEndpoint(QQuickItem *plasmoid)
 {
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
-
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
+    if (!m_endpoints.contains(plasmoid)) {
         return;
     }
 
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
+    removeFromLayoutIndex(plasmoid, m_endpoints[plasmoid].layoutName);
+    m_endpoints.remove(plasmoid);
 
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
+    //! the item may already be under destruction, only pointers are compared
+    disconnect(plasmoid, &QObject::destroyed, this, nullptr);
+}
 
-            if (childItems.isEmpty()) {
-                continue;
-            }
+void LaunchersSignals::removeFromLayoutIndex(QQuickItem *plasmoid, const QString &layoutName)
+{
+    auto it = m_layoutEndpoints.find(layoutName);
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalRemoveLauncher(QVariant,QVariant)");
+    if (it == m_layoutEndpoints.end()) {
+        return;
+    }
 
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+    it.value().removeAll(plasmoid);
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
-                }
-            }
-        }
+    if (it.value().isEmpty()) {
+        m_layoutEndpoints.erase(it);
     }
 }
 
-void LaunchersSignals::addLauncherToActivity(QString layoutName, int launcherGroup, QString launcher, QString activity)
+void LaunchersSignals::postMessage(Operation operation, QString layoutName, int senderId, int launcherGroup, QVariantList args)
 {
     Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
 
@@ -134,173 +127,100 @@ void LaunchersSignals::addLauncherToActivity(QString layoutName, int launcherGro
         return;
     }
 
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
-
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
-
-            if (childItems.isEmpty()) {
-                continue;
-            }
-
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalAddLauncherToActivity(QVariant,QVariant,QVariant)");
+    Message message;
+    message.operation = operation;
+    message.layoutName = (group == Dock::LayoutLaunchers) ? layoutName : "";
+    message.senderId = senderId;
+    message.args = args;
+    message.args.prepend(launcherGroup);
 
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+    m_messages.append(message);
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
-                }
-            }
-        }
+    if (!m_deliveryTimer.isActive()) {
+        m_deliveryTimer.start();
     }
 }
 
-void LaunchersSignals::removeLauncherFromActivity(QString layoutName, int launcherGroup, QString launcher, QString activity)
+void LaunchersSignals::deliverMessages()
 {
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
+    //! messages posted from the endpoints during delivery are sent at the next batch
+    QList<Message> messages;
+    messages.swap(m_messages);
 
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
-        return;
-    }
+    for (const auto &message : messages) {
+        QList<QQuickItem *> targets;
 
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
+        if (message.layoutName.isEmpty()) {
+            targets = m_endpoints.keys();
+        } else {
+            targets = m_layoutEndpoints.value(message.layoutName);
+        }
 
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
+        for (QQuickItem *target : targets) {
+            //! an endpoint may have been removed from a previous invocation
+            auto it = m_endpoints.constFind(target);
 
-            if (childItems.isEmpty()) {
+            if (it == m_endpoints.constEnd() || !it->item) {
                 continue;
             }
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalRemoveLauncherFromActivity(QVariant,QVariant,QVariant)");
-
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+            const Endpoint &endpoint = it.value();
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
-                }
+            if (message.senderId != -1 && endpoint.appletId == message.senderId) {
+                continue;
             }
-        }
-    }
-}
 
-void LaunchersSignals::urlsDropped(QString layoutName, int launcherGroup, QStringList urls)
-{
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
-
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
-        return;
-    }
+            const QMetaMethod &method = endpoint.methods[message.operation];
 
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
-
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
-
-            if (childItems.isEmpty()) {
+            if (!method.isValid()) {
                 continue;
             }
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalUrlsDropped(QVariant,QVariant)");
-
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+            const QVariantList &args = message.args;
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, urls));
-                }
+            if (args.count() == 2) {
+                method.invoke(target, Q_ARG(QVariant, args[0]), Q_ARG(QVariant, args[1]));
+            } else if (args.count() == 3) {
+                method.invoke(target, Q_ARG(QVariant, args[0]), Q_ARG(QVariant, args[1]), Q_ARG(QVariant, args[2]));
             }
         }
     }
 }
 
-void LaunchersSignals::moveTask(QString layoutName, int senderId, int launcherGroup, int from, int to)
+void LaunchersSignals::addLauncher(QString layoutName, int launcherGroup, QString launcher)
 {
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
-
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
-        return;
-    }
-
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
-
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (applet->id() != senderId) {
-            if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                const auto &childItems = appletInterface->childItems();
+    postMessage(AddLauncher, layoutName, -1, launcherGroup, {launcher});
+}
 
-                if (childItems.isEmpty()) {
-                    continue;
-                }
+void LaunchersSignals::removeLauncher(QString layoutName, int launcherGroup, QString launcher)
+{
+    postMessage(RemoveLauncher, layoutName, -1, launcherGroup, {launcher});
+}
 
-                for (QQuickItem *item : childItems) {
-                    if (auto *metaObject = item->metaObject()) {
-                        int methodIndex = metaObject->indexOfMethod("extSignalMoveTask(QVariant,QVariant,QVariant)");
+void LaunchersSignals::addLauncherToActivity(QString layoutName, int launcherGroup, QString launcher, QString activity)
+{
+    postMessage(AddLauncherToActivity, layoutName, -1, launcherGroup, {launcher, activity});
+}
 
-                        if (methodIndex == -1) {
-                            continue;
-                        }
+void LaunchersSignals::removeLauncherFromActivity(QString layoutName, int launcherGroup, QString launcher, QString activity)
+{
+    postMessage(RemoveLauncherFromActivity, layoutName, -1, launcherGroup, {launcher, activity});
+}
 
-                        QMetaMethod method = metaObject->method(methodIndex);
-                        method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, from), Q_ARG(QVariant, to));
-                    }
-                }
-            }
-        }
-    }
+void LaunchersSignals::urlsDropped(QString layoutName, int launcherGroup, QStringList urls)
+{
+    postMessage(UrlsDropped, layoutName, -1, launcherGroup, {urls});
 }
 
+void LaunchersSignals::moveTask(QString layoutName, int senderId, int launcherGroup, int from, int to)
+{
+    postMessage(MoveTask, layoutName, senderId, launcherGroup, {from, to});
+}
 
 void LaunchersSignals::internalSeparators(QString layoutName, int senderId, int launcherGroup,
         QStringList separators, QStringList indexes)
 {
-    Dock::LaunchersGroup group = static_cast<Dock::LaunchersGroup>(launcherGroup);
-
-    if ((Dock::LaunchersGroup)group == Dock::UniqueLaunchers) {
-        return;
-    }
-
-    QString lName = (group == Dock::LayoutLaunchers) ? layoutName : "";
-
-    foreach (auto applet, lattePlasmoids(lName)) {
-        if (applet->id() != senderId) {
-            if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                const auto &childItems = appletInterface->childItems();
-
-                if (childItems.isEmpty()) {
-                    continue;
-                }
-
-                for (QQuickItem *item : childItems) {
-                    if (auto *metaObject = item->metaObject()) {
-                        int methodIndex = metaObject->indexOfMethod("extSignalInternalSeparators(QVariant,QVariant,QVariant)");
-
-                        if (methodIndex == -1) {
-                            continue;
-                        }
-
-                        QMetaMethod method = metaObject->method(methodIndex);
-                        method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, separators), Q_ARG(QVariant, indexes));
-                    }
-                }
-            }
-        }
-    }
+    postMessage(InternalSeparators, layoutName, senderId, launcherGroup, {separators, indexes});
 }
 
-
 } //end of namespace
@@ -24,7 +24,13 @@
 #include "layoutmanager.h"
 #include "../liblattedock/dock.h"
 
+#include <QHash>
+#include <QMetaMethod>
 #include <QObject>
+#include <QPointer>
+#include <QQuickItem>
+#include <QTimer>
+#include <QVariant>
 
 class LayoutManager;
 
@@ -36,6 +42,10 @@ namespace Latte {
 //! crashes that occur by setting the launcherList of the tasksModel so
 //! often. The plasma devs of libtaskmanager have designed the launchers
 //! model to be initialized only once during startup
+//!
+//! Latte plasmoids register themselves as endpoints for their layout and
+//! the messages are queued and delivered in batches at the next event loop
+//! turn, the methods of the endpoints are resolved only once
 class LaunchersSignals : public QObject {
     Q_OBJECT
 
@@ -44,6 +54,9 @@ public:
     ~LaunchersSignals() override;
 
 public slots:
+    Q_INVOKABLE void registerEndpoint(QString layoutName, int appletId, QQuickItem *plasmoid);
+    Q_INVOKABLE void unregisterEndpoint(QQuickItem *plasmoid);
+
     Q_INVOKABLE void addLauncher(QString layoutName, int launcherGroup, QString launcher);
     Q_INVOKABLE void removeLauncher(QString layoutName, int launcherGroup, QString launcher);
     Q_INVOKABLE void addLauncherToActivity(QString layoutName, int launcherGroup, QString launcher, QString activity);
@@ -53,11 +66,50 @@ public slots:
     Q_INVOKABLE void internalSeparators(QString layoutName, int senderId, int launcherGroup,
                                         QStringList separators, QStringList indexes);
 
+private slots:
+    void deliverMessages();
+
 private:
-    QList<Plasma::Applet *> lattePlasmoids(QString layoutName);
+    enum Operation {
+        AddLauncher = 0,
+        RemoveLauncher,
+        AddLauncherToActivity,
+        RemoveLauncherFromActivity,
+        UrlsDropped,
+        MoveTask,
+        InternalSeparators,
+        OperationsCount
+    };
+
+    struct Endpoint {
+        QPointer<QQuickItem> item;
+        int appletId{ -1};
+        QString layoutName;
+        QMetaMethod methods[OperationsCount];
+    };
+
+    struct Message {
+        Operation operation;
+        //! empty for global launchers
+        QString layoutName;
+        //! the sender does not receive the message, -1 for all
+        int senderId{ -1};
+        QVariantList args;
+    };
+
+    void postMessage(Operation operation, QString layoutName, int senderId, int launcherGroup, QVariantList args);
+    void removeFromLayoutIndex(QQuickItem *plasmoid, const QString &layoutName);
 
 private:
     LayoutManager *m_manager{nullptr};
+
+    QTimer m_deliveryTimer;
+
+    QList<Message> m_messages;
+
+    QHash<QQuickItem *, Endpoint> m_endpoints;
+    //! layout name -> endpoints of that layout
+    QHash<QString, QList<QQuickItem *>> m_layoutEndpoints;
 };
 
 }
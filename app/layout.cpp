@@ -20,14 +20,23 @@
 
 #include "layout.h"
 
+#include "configserializer.h"
+#include "configsyncer.h"
+#include "layoutchecker.h"
 #include "screenpool.h"
+#include "startuptracer.h"
 
+#include <QBitArray>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <KSharedConfig>
 
 #include <KActivities/Consumer>
 
+#include <algorithm>
+
 namespace Latte {
 
 const QString Layout::MultipleLayoutsName = ".multiple-layouts_hidden";
@@ -37,6 +46,10 @@ Layout::Layout(QObject *parent, QString layoutFile, QString assignedName)
 {
     qDebug() << "Layout file to create object: " << layoutFile << " with name: " << assignedName;
 
+    m_stagedDocksTimer.setSingleShot(true);
+    m_stagedDocksTimer.setInterval(250);
+    connect(&m_stagedDocksTimer, &QTimer::timeout, this, &Layout::addNextStagedDock);
+
     if (QFile(layoutFile).exists()) {
         if (assignedName.isEmpty()) {
             assignedName =  layoutName(layoutFile);
@@ -52,32 +65,165 @@ Layout::Layout(QObject *parent, QString layoutFile, QString assignedName)
 
 Layout::~Layout()
 {
-    if (!m_layoutFile.isEmpty()) {
-        m_layoutGroup.sync();
-    }
 }
 
 void Layout::syncToLayoutFile()
 {
-    if (!m_corona) {
+    //! the file of a layout that is not materialized is already up to date
+    //! and syncing its empty containments list would clear it
+    if (!m_corona || !m_materialized) {
         return;
     }
 
     KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_layoutFile);
 
-    KConfigGroup oldContainments = KConfigGroup(filePtr, "Containments");
-    oldContainments.deleteGroup();
-    oldContainments.sync();
+    //! the file was changed outside of this layout, e.g. from an import,
+    //! so the recorded digests can not be trusted any more
+    QDateTime fileTime = QFileInfo(m_layoutFile).lastModified();
+
+    if (fileTime != m_syncedFileTime) {
+        filePtr->reparseConfiguration();
+        m_syncedDigests.clear();
+    }
+
+    KConfigGroup layoutContainments = KConfigGroup(filePtr, "Containments");
+
+    QStringList containmentsIds;
+    QHash<QString, QByteArray> digests;
+    bool changed{false};
+
+    foreach (auto containment, m_containments) {
+        KConfigGroup liveGroup = containment->config();
+
+        QString cId = QString::number(containment->id());
+        containmentsIds << cId;
+
+        //! the containment is already stored in that file
+        if (liveGroup.config() == filePtr.data()) {
+            continue;
+        }
+
+        KConfigGroup fileGroup = layoutContainments.group(cId);
+
+        //! containment entries and its non applets subgroups
+        QByteArray digest = groupDigest(liveGroup, true);
+        digests[cId] = digest;
+
+        if (!m_syncedDigests.contains(cId) || m_syncedDigests[cId] != digest) {
+            foreach (auto key, fileGroup.keyList()) {
+                fileGroup.deleteEntry(key);
+            }
+
+            foreach (auto subGroup, fileGroup.groupList()) {
+                if (subGroup != "Applets") {
+                    fileGroup.group(subGroup).deleteGroup();
+                }
+            }
+
+            QMap<QString, QString> entries = liveGroup.entryMap();
+
+            for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+                fileGroup.writeEntry(it.key(), it.value());
+            }
+
+            foreach (auto subGroup, liveGroup.groupList()) {
+                if (subGroup != "Applets") {
+                    KConfigGroup newGroup = fileGroup.group(subGroup);
+                    liveGroup.group(subGroup).copyTo(&newGroup);
+                }
+            }
+
+            fileGroup.writeEntry("layoutId", "");
+            changed = true;
+        }
+
+        //! applets
+        KConfigGroup liveApplets = liveGroup.group("Applets");
+        KConfigGroup fileApplets = fileGroup.group("Applets");
+        QStringList appletsIds = liveApplets.groupList();
+
+        foreach (auto aId, appletsIds) {
+            QString appletKey = cId + "/" + aId;
+            QByteArray appletDigest = groupDigest(liveApplets.group(aId));
+            digests[appletKey] = appletDigest;
+
+            if (!m_syncedDigests.contains(appletKey) || m_syncedDigests[appletKey] != appletDigest) {
+                KConfigGroup newGroup = fileApplets.group(aId);
+                newGroup.deleteGroup();
+                liveApplets.group(aId).copyTo(&newGroup);
+                changed = true;
+            }
+        }
+
+        foreach (auto aId, fileApplets.groupList()) {
+            if (!appletsIds.contains(aId)) {
+                fileApplets.group(aId).deleteGroup();
+                changed = true;
+            }
+        }
+    }
+
+    //! containments that were removed from the layout
+    foreach (auto cId, layoutContainments.groupList()) {
+        if (!containmentsIds.contains(cId)) {
+            layoutContainments.group(cId).deleteGroup();
+            changed = true;
+        }
+    }
+
+    m_syncedDigests = digests;
+
+    if (!changed) {
+        return;
+    }
 
     qDebug() << " LAYOUT :: " << m_layoutName << " is syncing its original file.";
 
+    //! a single sync, KConfig writes the file through QSaveFile so it is
+    //! replaced atomically and no intermediate state is ever found on disk
+    filePtr->sync();
+
+    m_syncedFileTime = QFileInfo(m_layoutFile).lastModified();
+}
+
+QByteArray Layout::groupDigest(const KConfigGroup &group, bool skipApplets) const
+{
+    return ConfigSerializer::digest(ConfigSerializer::groupData(group, skipApplets ? QStringLiteral("Applets") : QString()));
+}
+
+void Layout::syncDetachedContainmentsToLayoutFile(bool release)
+{
+    if (!m_corona || !QFile(m_layoutFile).exists()) {
+        return;
+    }
+
+    KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_layoutFile);
+    KConfigGroup layoutContainments = KConfigGroup(filePtr, "Containments");
+
+    bool changed{false};
+
     foreach (auto containment, m_containments) {
-        containment->config().writeEntry("layoutId", "");
-        KConfigGroup newGroup = oldContainments.group(QString::number(containment->id()));
-        containment->config().copyTo(&newGroup);
+        KConfigGroup config = containment->config();
+
+        if (config.config()->name() == m_layoutFile) {
+            continue;
+        }
+
+        qDebug() << " LAYOUT :: " << m_layoutName << " is syncing detached containment :: " << containment->id();
+
+        KConfigGroup newGroup = layoutContainments.group(QString::number(containment->id()));
+        config.copyTo(&newGroup);
+        changed = true;
+
+        if (release) {
+            config.deleteGroup();
+            config.sync();
+        }
     }
 
-    oldContainments.sync();
+    if (changed) {
+        layoutContainments.sync();
+    }
 }
 
 void Layout::unloadContainments()
@@ -133,6 +279,8 @@ void Layout::unloadDockViews()
 
     qDebug() << "Layout - " + name() + " unload: dockViews ... size: " << m_dockViews.size();
 
+    clearStagedDocks();
+
     qDeleteAll(m_dockViews);
     qDeleteAll(m_waitingDockViews);
     m_dockViews.clear();
@@ -154,6 +302,10 @@ void Layout::initToCorona(DockCorona *corona)
 
     foreach (auto containment, m_corona->containments()) {
         if (m_corona->layoutManager()->memoryUsage() == Dock::SingleLayout) {
+            if (m_corona->layoutManager()->isStandbyContainment(containment)) {
+                continue;
+            }
+
             addContainment(containment);
         } else if (m_corona->layoutManager()->memoryUsage() == Dock::MultipleLayouts) {
             QString layoutId = containment->config().readEntry("layoutId", QString());
@@ -334,106 +486,107 @@ bool Layout::isOriginalLayout() const
     return m_layoutName != MultipleLayoutsName;
 }
 
-bool Layout::layoutIsBroken() const
+bool Layout::isMaterialized() const
 {
-    if (m_layoutFile.isEmpty() || !QFile(m_layoutFile).exists()) {
-        return false;
-    }
+    return m_materialized;
+}
+
+void Layout::setMaterialized(bool materialized)
+{
+    m_materialized = materialized;
+}
 
-    QStringList ids;
-    QStringList conts;
-    QStringList applets;
+bool Layout::isStandby() const
+{
+    return m_standby;
+}
+
+void Layout::setStandby(bool standby)
+{
+    if (m_standby == standby || !m_corona) {
+        return;
+    }
 
-    KSharedConfigPtr lFile = KSharedConfig::openConfig(m_layoutFile);
+    qDebug() << "Layout - " + name() + " standby ::: " << standby;
 
+    m_standby = standby;
 
-    if (!m_corona) {
-        KConfigGroup containmentsEntries = KConfigGroup(lFile, "Containments");
-        ids << containmentsEntries.groupList();
-        conts << ids;
+    if (m_standby) {
+        //! the docks that are still waiting to be created are dropped
+        clearStagedDocks();
 
-        foreach (auto cId, containmentsEntries.groupList()) {
-            auto appletsEntries = containmentsEntries.group(cId).group("Applets");
+        //! the containments of a standby layout keep writing their settings
+        //! to the layout file, make sure that everything is stored on disk
+        syncDetachedContainmentsToLayoutFile();
 
-            ids << appletsEntries.groupList();
-            applets << appletsEntries.groupList();
+        foreach (auto containment, m_containments) {
+            containment->config().sync();
         }
     } else {
-        foreach (auto containment, m_containments) {
-            ids << QString::number(containment->id());
-            conts << ids;
+        updateLastUsedActivity();
+    }
 
-            foreach (auto applet, containment->applets()) {
-                ids << QString::number(applet->id());
-                applets << QString::number(applet->id());
-            }
-        }
+    foreach (auto view, m_dockViews) {
+        view->setVisible(!m_standby);
     }
 
-    QSet<QString> idsSet = QSet<QString>::fromList(ids);
+    emit standbyChanged();
+    emit m_corona->docksCountChanged();
+    emit m_corona->availableScreenRectChanged();
+    emit m_corona->availableScreenRegionChanged();
+}
 
-    /* a different way to count duplicates
-    QMap<QString, int> countOfStrings;
+qint64 Layout::estimatedMemoryUsage() const
+{
+    qint64 bytes{0};
 
-    for (int i = 0; i < ids.count(); i++) {
-        countOfStrings[ids[i]]++;
-    }*/
+    foreach (auto view, m_dockViews) {
+        const qreal ratio = view->devicePixelRatio();
 
-    if (idsSet.count() != ids.count()) {
-        qDebug() << "   ----   ERROR - BROKEN LAYOUT :: " << m_layoutName << " ----";
+        //! front and back buffers of the scene graph
+        bytes += qint64(view->width() * ratio) * qint64(view->height() * ratio) * 4 * 2;
+    }
 
-        if (!m_corona) {
-            qDebug() << "   ---- file : " << m_layoutFile;
-        } else {
-            qDebug() << "   ---- in multiple layouts hidden file : " << Importer::layoutFilePath(Layout::MultipleLayoutsName);
-        }
+    return bytes;
+}
 
-        qDebug() << "Contaiments :: " << conts;
-        qDebug() << "Applets :: " << applets;
+bool Layout::layoutIsBroken() const
+{
+    if (m_layoutFile.isEmpty() || !QFile(m_layoutFile).exists()) {
+        return false;
+    }
 
-        foreach (QString c, conts) {
-            if (applets.contains(c)) {
-                qDebug() << "Error: Same applet and containment id found ::: " << c;
-            }
-        }
+    LayoutChecker checker;
 
-        for (int i = 0; i < ids.count(); ++i) {
-            for (int j = i + 1; j < ids.count(); ++j) {
-                if (ids[i] == ids[j]) {
-                    qDebug() << "Error: Applets with same id ::: " << ids[i];
-                }
-            }
+    if (!m_corona) {
+        checker.addFile(m_layoutFile);
+    } else {
+        foreach (auto containment, m_containments) {
+            checker.addContainment(containment->config());
         }
+    }
 
-        qDebug() << "  -- - -- - -- - -- - - -- - - - - -- - - - - ";
+    if (checker.hasDuplicateIds()) {
+        qDebug() << "   ----   ERROR - BROKEN LAYOUT :: " << m_layoutName << " ----";
 
         if (!m_corona) {
-            KConfigGroup containmentsEntries = KConfigGroup(lFile, "Containments");
-
-            foreach (auto cId, containmentsEntries.groupList()) {
-                auto appletsEntries = containmentsEntries.group(cId).group("Applets");
-
-                qDebug() << " CONTAINMENT : " << cId << " APPLETS : " << appletsEntries.groupList();
-            }
+            qDebug() << "   ---- file : " << m_layoutFile;
         } else {
-            foreach (auto containment, m_containments) {
-                QStringList appletsIds;
-
-                foreach (auto applet, containment->applets()) {
-                    appletsIds << QString::number(applet->id());
-                }
+            qDebug() << "   ---- in multiple layouts hidden file : " << Importer::layoutFilePath(Layout::MultipleLayoutsName);
+        }
 
-                qDebug() << " CONTAINMENT : " << containment->id() << " APPLETS : " << appletsIds.join(",");
-            }
+        foreach (auto line, checker.report()) {
+            qDebug() << "Error: " << line;
         }
 
+        qDebug() << "  -- - -- - -- - -- - - -- - - - - -- - - - - ";
+
         return true;
     }
 
     return false;
 }
 
-
 QString Layout::layoutName(const QString &fileName)
 {
     int lastSlash = fileName.lastIndexOf("/");
@@ -460,26 +613,30 @@ void Layout::loadConfig()
 void Layout::saveConfig()
 {
     qDebug() << "layout is saving... for layout:" << m_layoutName;
-    m_layoutGroup.writeEntry("version", m_version);
-    m_layoutGroup.writeEntry("showInMenu", m_showInMenu);
-    m_layoutGroup.writeEntry("color", m_color);
-    m_layoutGroup.writeEntry("launchers", m_launchers);
-    m_layoutGroup.writeEntry("activities", m_activities);
+    ConfigSyncer *syncer = ConfigSyncer::self();
 
-    m_layoutGroup.sync();
+    syncer->writeEntry(m_layoutGroup, "version", m_version);
+    syncer->writeEntry(m_layoutGroup, "showInMenu", m_showInMenu);
+    syncer->writeEntry(m_layoutGroup, "color", m_color);
+    syncer->writeEntry(m_layoutGroup, "launchers", m_launchers);
+    syncer->writeEntry(m_layoutGroup, "activities", m_activities);
 }
 
 //! Containments Actions
 
 void Layout::addContainment(Plasma::Containment *containment)
 {
-    if (!containment || m_containments.contains(containment)) {
+    if (!containment || m_containments.contains(containment) || m_standby) {
         return;
     }
 
     bool containmentInLayout{false};
 
     if (m_corona->layoutManager()->memoryUsage() == Dock::SingleLayout) {
+        if (m_corona->layoutManager()->isStandbyContainment(containment)) {
+            return;
+        }
+
         m_containments.append(containment);
         containmentInLayout = true;
     } else if (m_corona->layoutManager()->memoryUsage() == Dock::MultipleLayouts) {
@@ -492,7 +649,12 @@ void Layout::addContainment(Plasma::Containment *containment)
     }
 
     if (containmentInLayout) {
-        addDock(containment);
+        if (m_stagedLoading) {
+            m_stagedDocks.append(containment);
+        } else {
+            addDock(containment);
+        }
+
         connect(containment, &QObject::destroyed, this, &Layout::containmentDestroyed);
     }
 }
@@ -608,6 +770,8 @@ void Layout::addDock(Plasma::Containment *containment, bool forceLoading, int ex
         return;
     }
 
+    StartupSpan span(QStringLiteral("Layout::addDock"), {{QStringLiteral("containment"), containment->id()}});
+
     auto metadata = containment->kPackage().metadata();
 
     qDebug() << "step 1...";
@@ -680,10 +844,25 @@ void Layout::addDock(Plasma::Containment *containment, bool forceLoading, int ex
         dockWin = containment->config().readEntry("dockWindowBehavior", true);
     }
 
-    auto dockView = new DockView(m_corona, nextScreen, dockWin);
-    dockView->init();
-    dockView->setContainment(containment);
-    dockView->setManagedLayout(this);
+    //! a dock view of the previous layout with the same plugin, edge,
+    //! screen and window behavior is reused instead of creating a new window
+    auto dockView = m_corona->layoutManager()->takeRecycledDockView(containment);
+
+    if (!dockView) {
+        StartupSpan span(QStringLiteral("DockView::init"), {{QStringLiteral("containment"), containment->id()}});
+
+        dockView = new DockView(m_corona, nextScreen, dockWin);
+        dockView->init();
+    }
+
+    StartupTracer::self()->traceFirstFrame(dockView, containment->id());
+
+    {
+        StartupSpan span(QStringLiteral("DockView::setContainment"), {{QStringLiteral("containment"), containment->id()}});
+
+        dockView->setContainment(containment);
+        dockView->setManagedLayout(this);
+    }
 
     //! force this special dock case to become primary
     //! even though it isnt
@@ -713,6 +892,147 @@ void Layout::addDock(Plasma::Containment *containment, bool forceLoading, int ex
     emit m_corona->docksCountChanged();
 }
 
+bool Layout::containsTasks(Plasma::Containment *containment)
+{
+    if (!containment) {
+        return false;
+    }
+
+    foreach (auto applet, containment->applets()) {
+        const auto &provides = KPluginMetaData::readStringList(applet->pluginMetaData().rawData(), QStringLiteral("X-Plasma-Provides"));
+
+        if (provides.contains(QLatin1String("org.kde.plasma.multitasking"))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Layout::hasStagedDocks() const
+{
+    return m_stagedLoading || !m_stagedDocks.isEmpty();
+}
+
+void Layout::beginStagedDocks()
+{
+    //! a standby layout does not create any docks
+    if (m_standby) {
+        return;
+    }
+
+    m_stagedLoading = true;
+}
+
+int Layout::stagedDockPriority(Plasma::Containment *containment) const
+{
+    bool onPrimary = containment->config().readEntry("onPrimary", true);
+
+    if (containment->id() == m_priorityContainmentId) {
+        return 0;
+    } else if (onPrimary) {
+        return 1;
+    }
+
+    return 2;
+}
+
+void Layout::commitStagedDocks(int priorityContainmentId, bool forcePriorityDock)
+{
+    if (m_standby) {
+        clearStagedDocks();
+        return;
+    }
+
+    m_stagedLoading = false;
+
+    //! containments that were present before the staged loading started
+    foreach (auto containment, m_containments) {
+        if (!m_dockViews.contains(containment) && !m_stagedDocks.contains(containment)) {
+            m_stagedDocks.append(containment);
+        }
+    }
+
+    if (priorityContainmentId == -1) {
+        foreach (auto containment, m_stagedDocks) {
+            if (containment && containment->config().readEntry("onPrimary", true) && containsTasks(containment)) {
+                priorityContainmentId = containment->id();
+                break;
+            }
+        }
+    }
+
+    m_priorityContainmentId = priorityContainmentId;
+    m_forcePriorityDock = forcePriorityDock;
+
+    //! the docks on primary screen are created before the explicit ones,
+    //! the containment order is kept for docks of the same priority
+    m_stagedDocks.removeAll(QPointer<Plasma::Containment>());
+
+    std::stable_sort(m_stagedDocks.begin(), m_stagedDocks.end(),
+    [this](const QPointer<Plasma::Containment> &c1, const QPointer<Plasma::Containment> &c2) {
+        return stagedDockPriority(c1) < stagedDockPriority(c2);
+    });
+
+    if (!m_stagedDocksTimer.isActive()) {
+        addNextStagedDock();
+    }
+}
+
+void Layout::addNextStagedDock()
+{
+    //! the fallback timer may fire before the frame of the previous dock
+    m_stagedDocksTimer.stop();
+    disconnect(m_stagedDockFrameConnection);
+
+    if (m_standby) {
+        clearStagedDocks();
+        return;
+    }
+
+    while (!m_stagedDocks.isEmpty()) {
+        QPointer<Plasma::Containment> containment = m_stagedDocks.takeFirst();
+
+        if (!containment || m_dockViews.contains(containment) || !m_containments.contains(containment)) {
+            continue;
+        }
+
+        bool forceLoading = m_forcePriorityDock && containment->id() == m_priorityContainmentId;
+        addDock(containment, forceLoading);
+
+        DockView *dockView = m_dockViews.value(containment);
+
+        if (dockView && !m_stagedDocks.isEmpty()) {
+            //! the next dock is created after this one has been painted, frameSwapped
+            //! is emitted from the render thread so it is received queued
+            m_stagedDockFrameConnection = connect(dockView, &QQuickWindow::frameSwapped, this, [this]() {
+                if (m_stagedDocksTimer.isActive()) {
+                    addNextStagedDock();
+                }
+            }, Qt::QueuedConnection);
+
+            m_stagedDocksTimer.start();
+            return;
+        }
+    }
+
+    emit stagedDocksFinished();
+}
+
+void Layout::clearStagedDocks()
+{
+    bool hadStagedDocks = hasStagedDocks();
+
+    m_stagedLoading = false;
+    m_stagedDocksTimer.stop();
+    disconnect(m_stagedDockFrameConnection);
+    m_stagedDocks.clear();
+
+    if (hadStagedDocks) {
+        emit stagedDocksFinished();
+    }
+}
+
 void Layout::copyDock(Plasma::Containment *containment)
 {
     if (!containment || !m_corona)
@@ -887,6 +1207,8 @@ void Layout::importToCorona()
         return;
     }
 
+    ConfigSyncer::self()->flush();
+
     //! Settting mutable for create a containment
     m_corona->setImmutability(Plasma::Types::Mutable);
 
@@ -915,184 +1237,170 @@ void Layout::importToCorona()
     importLayoutFile(temp2File);
 }
 
-QString Layout::availableId(QStringList all, QStringList assigned, int base)
+QString Layout::availableId(QBitArray &usedIds, int &cursor)
 {
-    bool found = false;
-
-    int i = base;
-
-    while (!found && i < 32000) {
-        QString iStr = QString::number(i);
-
-        if (!all.contains(iStr) && !assigned.contains(iStr)) {
-            return iStr;
-        }
+    //! the cursor only moves forward because the used ids are never released
+    //! during an assignment, that way every id of the bitmap is visited once
+    while (cursor < usedIds.size() && usedIds.testBit(cursor)) {
+        cursor++;
+    }
 
-        i++;
+    if (cursor >= 32000) {
+        return QString("");
     }
 
-    return QString("");
+    markUsedId(usedIds, cursor);
+
+    return QString::number(cursor++);
 }
 
-QString Layout::newUniqueIdsLayoutFromFile(QString file)
+void Layout::markUsedId(QBitArray &usedIds, int id)
 {
-    if (!m_corona) {
-        return QString();
+    if (id < 0) {
+        return;
     }
 
-    QString tempFile = QDir::homePath() + "/.config/lattedock.copy2.bak";
-
-    QFile copyFile(tempFile);
+    if (id >= usedIds.size()) {
+        usedIds.resize(qMax(id + 1, 2 * usedIds.size()));
+    }
 
-    if (copyFile.exists())
-        copyFile.remove();
+    usedIds.setBit(id);
+}
 
-    //! BEGIN updating the ids in the temp file
-    QStringList allIds;
-    allIds << m_corona->containmentsIds();
-    allIds << m_corona->appletsIds();
+QBitArray Layout::coronaUsedIds(DockCorona *corona)
+{
+    QBitArray usedIds(256);
 
-    QStringList toInvestigateContainmentIds;
-    QStringList toInvestigateAppletIds;
-    QStringList toInvestigateSystrayContIds;
+    if (!corona) {
+        return usedIds;
+    }
 
-    //! first is the systray containment id
-    QHash<QString, QString> systrayParentContainmentIds;
-    QHash<QString, QString> systrayAppletIds;
+    foreach (auto containment, corona->containments()) {
+        markUsedId(usedIds, containment->id());
 
-    //qDebug() << "Ids:" << allIds;
+        foreach (auto applet, containment->applets()) {
+            markUsedId(usedIds, applet->id());
+        }
+    }
 
-    //qDebug() << "to copy containments: " << toCopyContainmentIds;
-    //qDebug() << "to copy applets: " << toCopyAppletIds;
+    return usedIds;
+}
 
-    QStringList assignedIds;
+QHash<QString, QString> Layout::assignUniqueIds(const KConfigGroup &containments, const QStringList &containmentIds, QBitArray &usedIds)
+{
     QHash<QString, QString> assigned;
 
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
-    KConfigGroup investigate_conts = KConfigGroup(filePtr, "Containments");
-    //KConfigGroup copied_c1 = KConfigGroup(&copied_conts, QString::number(containment->id()));
-
-    //! Record the containment and applet ids
-    foreach (auto cId, investigate_conts.groupList()) {
-        toInvestigateContainmentIds << cId;
-        auto appletsEntries = investigate_conts.group(cId).group("Applets");
-        toInvestigateAppletIds << appletsEntries.groupList();
-
-        //! investigate for systrays
-        foreach (auto appletId, appletsEntries.groupList()) {
-            KConfigGroup appletSettings = appletsEntries.group(appletId).group("Configuration");
+    int containmentCursor{12};
+    int appletCursor{40};
 
-            int tSysId = appletSettings.readEntry("SystrayContainmentId", -1);
+    foreach (auto contId, containmentIds) {
+        assigned[contId] = availableId(usedIds, containmentCursor);
+    }
 
-            //! It is a systray !!!
-            if (tSysId != -1) {
-                QString tSysIdStr = QString::number(tSysId);
-                toInvestigateSystrayContIds << tSysIdStr;
-                systrayParentContainmentIds[tSysIdStr] = cId;
-                systrayAppletIds[tSysIdStr] = appletId;
-                qDebug() << "systray was found in the containment...";
-            }
+    foreach (auto contId, containmentIds) {
+        foreach (auto appId, containments.group(contId).group("Applets").groupList()) {
+            assigned[appId] = availableId(usedIds, appletCursor);
         }
     }
 
-    //! Reassign containment and applet ids to unique ones
-    foreach (auto contId, toInvestigateContainmentIds) {
-        QString newId = availableId(allIds, assignedIds, 12);
+    return assigned;
+}
+
+void Layout::copyContainmentsWithIds(const KConfigGroup &containments, const QStringList &containmentIds,
+                                     const QHash<QString, QString> &assigned, const QString &layoutId, KConfigGroup &target)
+{
+    //! the source is only read and the target is written once. Because the new
+    //! groups live in a different file the old and the new ids can not collide,
+    //! even when they are swapped between two groups
+    foreach (auto contId, containmentIds) {
+        KConfigGroup containmentGroup = containments.group(contId);
+        KConfigGroup newContainmentGroup = target.group(assigned[contId]);
 
-        assignedIds << newId;
-        assigned[contId] = newId;
-    }
+        const auto entries = containmentGroup.entryMap();
 
-    foreach (auto appId, toInvestigateAppletIds) {
-        QString newId = availableId(allIds, assignedIds, 40);
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            newContainmentGroup.writeEntry(it.key(), it.value());
+        }
 
-        assignedIds << newId;
-        assigned[appId] = newId;
-    }
+        foreach (auto subgroupName, containmentGroup.groupList()) {
+            if (subgroupName == QLatin1String("Applets")) {
+                continue;
+            }
 
-    qDebug() << "ALL CORONA IDS ::: " << allIds;
-    qDebug() << "FULL ASSIGNMENTS ::: " << assigned;
+            KConfigGroup newSubgroup = newContainmentGroup.group(subgroupName);
+            containmentGroup.group(subgroupName).copyTo(&newSubgroup);
+        }
 
-    foreach (auto cId, toInvestigateContainmentIds) {
-        QString value = assigned[cId];
+        //! update applet ids in their containment order and in MultipleLayouts update also the layoutId
+        foreach (auto settingStr, QStringList({"appletOrder", "lockedZoomApplets"})) {
+            QString order = containmentGroup.group("General").readEntry(settingStr, QString());
 
-        if (assigned.contains(value)) {
-            QString value2 = assigned[value];
+            if (!order.isEmpty()) {
+                QStringList fixedOrderIds;
 
-            if (cId != assigned[cId] && !value2.isEmpty() && cId == value2) {
-                qDebug() << "PROBLEM APPEARED !!!! FOR :::: " << cId << " .. fixed ..";
-                assigned[cId] = cId;
-                assigned[value] = value;
+                foreach (auto appId, order.split(";")) {
+                    fixedOrderIds.append(assigned.value(appId));
+                }
+
+                newContainmentGroup.group("General").writeEntry(settingStr, fixedOrderIds.join(";"));
             }
         }
-    }
 
-    foreach (auto aId, toInvestigateAppletIds) {
-        QString value = assigned[aId];
+        if (!layoutId.isEmpty()) {
+            newContainmentGroup.writeEntry("layoutId", layoutId);
+        }
+
+        KConfigGroup appletsGroup = containmentGroup.group("Applets");
+        KConfigGroup newAppletsGroup = newContainmentGroup.group("Applets");
 
-        if (assigned.contains(value)) {
-            QString value2 = assigned[value];
+        foreach (auto appId, appletsGroup.groupList()) {
+            KConfigGroup appletGroup = appletsGroup.group(appId);
+            KConfigGroup newAppletGroup = newAppletsGroup.group(assigned[appId]);
+            appletGroup.copyTo(&newAppletGroup);
 
-            if (aId != assigned[aId] && !value2.isEmpty() && aId == value2) {
-                qDebug() << "PROBLEM APPEARED !!!! FOR :::: " << aId << " .. fixed ..";
-                assigned[aId] = aId;
-                assigned[value] = value;
+            //! must update also the systray id in its applet
+            int tSysId = appletGroup.group("Configuration").readEntry("SystrayContainmentId", -1);
+
+            if (tSysId != -1) {
+                qDebug() << "systray was found in the containment...";
+                newAppletGroup.group("Configuration").writeEntry("SystrayContainmentId", assigned.value(QString::number(tSysId)));
             }
         }
     }
+}
 
-    qDebug() << "FIXED FULL ASSIGNMENTS ::: " << assigned;
+QString Layout::newUniqueIdsLayoutFromFile(QString file)
+{
+    if (!m_corona) {
+        return QString();
+    }
 
-    //! update applet ids in their contaiment order and in MultipleLayouts update also the layoutId
-    foreach (auto cId, investigate_conts.groupList()) {
-        //! Update (appletOrder) and (lockedZoomApplets)
-        for (int i = 1; i <= 2; ++i) {
-            QString settingStr = (i == 1) ? "appletOrder" : "lockedZoomApplets";
-            QString order1 = investigate_conts.group(cId).group("General").readEntry(settingStr, QString());
+    QString tempFile = QDir::homePath() + "/.config/lattedock.copy2.bak";
 
-            if (!order1.isEmpty()) {
-                QStringList order1Ids = order1.split(";");
-                QStringList fixedOrder1Ids;
+    QFile copyFile(tempFile);
 
-                for (int i = 0; i < order1Ids.count(); ++i) {
-                    fixedOrder1Ids.append(assigned[order1Ids[i]]);
-                }
+    if (copyFile.exists())
+        copyFile.remove();
 
-                QString fixedOrder1 = fixedOrder1Ids.join(";");
-                investigate_conts.group(cId).group("General").writeEntry(settingStr, fixedOrder1);
-            }
-        }
+    //! the corona ids are recorded in a bitmap, so each new id is found
+    //! without searching the corona ids and the already assigned ones
+    QBitArray usedIds = coronaUsedIds(m_corona);
 
-        if (m_corona->layoutManager()->memoryUsage() == Dock::MultipleLayouts) {
-            investigate_conts.group(cId).writeEntry("layoutId", m_layoutName);
-        }
-    }
+    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
+    KConfigGroup investigate_conts = KConfigGroup(filePtr, "Containments");
+    QStringList toInvestigateContainmentIds = investigate_conts.groupList();
 
-    //! must update also the systray id in its applet
-    foreach (auto systrayId, toInvestigateSystrayContIds) {
-        KConfigGroup systrayParentContainment = investigate_conts.group(systrayParentContainmentIds[systrayId]);
-        systrayParentContainment.group("Applets").group(systrayAppletIds[systrayId]).group("Configuration").writeEntry("SystrayContainmentId", assigned[systrayId]);
-        systrayParentContainment.sync();
-    }
+    QHash<QString, QString> assigned = assignUniqueIds(investigate_conts, toInvestigateContainmentIds, usedIds);
 
-    investigate_conts.sync();
+    qDebug() << "FULL ASSIGNMENTS ::: " << assigned;
 
-    //! Copy To Temp 2 File And Update Correctly The Ids
+    //! Copy To Temp 2 File And Update Correctly The Ids in a single pass
     KSharedConfigPtr file2Ptr = KSharedConfig::openConfig(tempFile);
     KConfigGroup fixedNewContainmets = KConfigGroup(file2Ptr, "Containments");
 
-    foreach (auto contId, investigate_conts.groupList()) {
-        KConfigGroup newContainmentGroup = fixedNewContainmets.group(assigned[contId]);
-        investigate_conts.group(contId).copyTo(&newContainmentGroup);
-
-        newContainmentGroup.group("Applets").deleteGroup();
+    QString layoutId = (m_corona->layoutManager()->memoryUsage() == Dock::MultipleLayouts) ? m_layoutName : QString();
 
-        foreach (auto appId, investigate_conts.group(contId).group("Applets").groupList()) {
-            KConfigGroup appletGroup = investigate_conts.group(contId).group("Applets").group(appId);
-            KConfigGroup newAppletGroup = fixedNewContainmets.group(assigned[contId]).group("Applets").group(assigned[appId]);
-            appletGroup.copyTo(&newAppletGroup);
-        }
-    }
+    copyContainmentsWithIds(investigate_conts, toInvestigateContainmentIds, assigned, layoutId, fixedNewContainmets);
 
     fixedNewContainmets.sync();
 
@@ -1169,46 +1477,84 @@ void Layout::recreateDock(Plasma::Containment *containment)
     });
 }
 
+Layout::DockPlacement Layout::dockPlacement(Plasma::Containment *containment) const
+{
+    DockPlacement placement;
+
+    int id = containment->screen();
+
+    if (id == -1) {
+        id = containment->lastScreen();
+    }
+
+    KConfigGroup config = containment->config();
+    placement.onPrimary = config.readEntry("onPrimary", true);
+    placement.location = static_cast<Plasma::Types::Location>((int)config.readEntry("location", (int)Plasma::Types::BottomEdge));
+    placement.connector = m_corona->screenPool()->connector(id);
+
+    return placement;
+}
+
 //! the central functions that updates loading/unloading dockviews
 //! concerning screen changed (for multi-screen setups mainly)
-void Layout::syncDockViewsToScreens()
+void Layout::syncDockViewsToScreens(const ScreenTopology::Delta &delta)
 {
-    if (!m_corona) {
+    if (!m_corona || delta.isEmpty()) {
         return;
     }
 
     qDebug() << "screen count changed -+-+ " << qGuiApp->screens().size();
 
+    QScreen *primaryScreen = qGuiApp->primaryScreen();
+    QSet<QString> screens;
+
+    foreach (auto scr, qGuiApp->screens()) {
+        screens.insert(scr->name());
+    }
+
+    //! the placement of each containment is read once from its config
+    QHash<const Plasma::Containment *, DockPlacement> placements;
+
+    foreach (auto cont, m_containments) {
+        placements[cont] = dockPlacement(cont);
+    }
+
     qDebug() << "adding consideration....";
     qDebug() << "dock view running : " << m_dockViews.count();
 
-    foreach (auto scr, qGuiApp->screens()) {
-        qDebug() << "Found screen: " << scr->name();
+    QList<Plasma::Types::Location> primaryFreeEdges = m_corona->freeEdges(primaryScreen);
 
-        foreach (auto cont, m_corona->containments()) {
-            int id = cont->screen();
+    foreach (auto cont, m_containments) {
+        if (m_dockViews.contains(cont) || m_corona->layoutManager()->isStandbyContainment(cont)) {
+            continue;
+        }
 
-            if (id == -1) {
-                id = cont->lastScreen();
-            }
+        const DockPlacement &placement = placements[cont];
 
-            bool onPrimary = cont->config().readEntry("onPrimary", true);
-            Plasma::Types::Location location = static_cast<Plasma::Types::Location>((int)cont->config().readEntry("location", (int)Plasma::Types::BottomEdge));
-
-            //! two main situations that a dock must be added when it is not already running
-            //! 1. when a dock is primary, not running and the edge for which is associated is free
-            //! 2. when a dock in explicit, not running and the associated screen currently exists
-            //! e.g. the screen has just been added
-            if (((onPrimary && m_corona->freeEdges(qGuiApp->primaryScreen()).contains(location)) || (!onPrimary && (m_corona->screenPool()->connector(id) == scr->name())))
-                && (!m_dockViews.contains(cont))) {
-                qDebug() << "screen Count signal: view must be added... for:" << scr->name();
-                addDock(cont);
+        //! two main situations that a dock must be added when it is not already running
+        //! 1. when a dock is primary, not running and the edge for which is associated is free
+        //! 2. when a dock in explicit, not running and the associated screen currently exists
+        //! e.g. the screen has just been added
+        if ((placement.onPrimary && primaryFreeEdges.contains(placement.location))
+            || (!placement.onPrimary && screens.contains(placement.connector))) {
+            qDebug() << "screen Count signal: view must be added... for:" << placement.connector;
+            addDock(cont);
+
+            if (m_dockViews.contains(cont) && m_dockViews[cont]->currentScreen() == primaryScreen->name()) {
+                primaryFreeEdges.removeAll(placement.location);
             }
         }
     }
 
     qDebug() << "removing consideration & updating screen for always on primary docks....";
 
+    //! a dock is found when its screen is running or when it follows the primary screen
+    QHash<DockView *, bool> foundViews;
+
+    foreach (auto view, m_dockViews) {
+        foundViews[view] = screens.contains(view->currentScreen()) || view->onPrimary();
+    }
+
     //! this code tries to find a containment that must not be deleted by
     //! automatic algorithm. Currently the containment with the minimum id
     //! containing tasks plasmoid wins
@@ -1218,22 +1564,14 @@ void Layout::syncDockViewsToScreens()
     //! associate correct values for preserveContainmentId and
     //! dockWithTasksWillBeShown
     foreach (auto view, m_dockViews) {
-        bool found{false};
-
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr->name() == view->currentScreen()
-                || (view->onPrimary() && scr == qGuiApp->primaryScreen())) {
-                found = true;
-                break;
-            }
-        }
+        bool found = foundViews[view];
 
         //!check if a tasks dock will be shown (try to prevent its deletion)
         if (found && view->tasksPresent()) {
             dockWithTasksWillBeShown = true;
         }
 
-        if (!found && !view->onPrimary() && (m_dockViews.size() > 1) && m_dockViews.contains(view->containment())
+        if (!found && !view->onPrimary() && (m_dockViews.size() > 1)
             && !(view->tasksPresent() && m_corona->noDocksWithTasks() == 1)) { //do not delete last dock containing tasks
             if (view->tasksPresent()) {
                 if (preserveContainmentId == -1)
@@ -1251,16 +1589,7 @@ void Layout::syncDockViewsToScreens()
     //! the last tasks dock which will exist in the end will be the one
     //! with the lowest containment id
     foreach (auto view, m_dockViews) {
-        bool found{false};
-
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr->name() == view->currentScreen()
-                || (view->onPrimary() && scr == qGuiApp->primaryScreen())) {
-                found = true;
-                break;
-            }
-        }
-
+        bool found = foundViews[view];
 
         //! which explicit docks can be deleted
         if (!found && !view->onPrimary() && (m_dockViews.size() > 1) && m_dockViews.contains(view->containment())
@@ -1274,13 +1603,15 @@ void Layout::syncDockViewsToScreens()
 
             //!which primary docks can be deleted
         } else if (view->onPrimary() && !found
-                   && !m_corona->freeEdges(qGuiApp->primaryScreen()).contains(view->location())) {
+                   && !m_corona->freeEdges(primaryScreen).contains(view->location())) {
             qDebug() << "screen Count signal: primary view must be deleted... for:" << view->currentScreen();
             auto viewToDelete = m_dockViews.take(view->containment());
             viewToDelete->deleteLater();
-        } else {
+        } else if (delta.primaryChanged || !delta.removed.isEmpty() || delta.affects(view->currentScreen())
+                   || (placements.contains(view->containment()) && delta.affects(placements[view->containment()].connector))) {
             //! if the dock will not be deleted its a very good point to reconsider
-            //! if the screen in which is running is the correct one
+            //! if the screen in which is running is the correct one. A removed screen
+            //! may have freed an edge of the primary screen for any dock
             view->reconsiderScreen();
         }
     }
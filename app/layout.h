@@ -21,12 +21,17 @@
 #ifndef LAYOUT_H
 #define LAYOUT_H
 
+#include <QBitArray>
+#include <QDateTime>
 #include <QObject>
+#include <QPointer>
+#include <QTimer>
 
 #include <KConfigGroup>
 #include <KSharedConfig>
 
 #include "dockcorona.h"
+#include "screentopology.h"
 
 namespace Latte {
 
@@ -43,6 +48,7 @@ class Layout : public QObject {
     Q_PROPERTY(QString name READ name NOTIFY nameChanged)
     Q_PROPERTY(QStringList launchers READ launchers WRITE setLaunchers NOTIFY launchersChanged)
     Q_PROPERTY(QStringList activities READ activities WRITE setActivities NOTIFY activitiesChanged)
+    Q_PROPERTY(bool standby READ isStandby NOTIFY standbyChanged)
 
 public:
     Layout(QObject *parent, QString layoutFile, QString layoutName = QString());
@@ -65,6 +71,26 @@ public:
     //!it is original layout compared to pseudo-layouts that are combinations of multiple-original layouts
     bool isOriginalLayout() const;
 
+    //!in MultipleLayouts the layout of a background activity can be kept only
+    //!as parsed settings, its containments and docks are created when one of
+    //!its activities becomes current
+    bool isMaterialized() const;
+    void setMaterialized(bool materialized);
+
+    //!this layout is loaded but its docks are hidden, it is used in SingleLayout
+    //!mode in order to switch instantly between recently used layouts
+    bool isStandby() const;
+    void setStandby(bool standby);
+
+    //!estimation in bytes for the window buffers held by its docks
+    qint64 estimatedMemoryUsage() const;
+
+    //!containments created while this layout was reactivated from standby are
+    //!stored in the corona configuration file of another layout, this function
+    //!copies them to the layout file and when release is set it also removes
+    //!them from the foreign file
+    void syncDetachedContainmentsToLayoutFile(bool release = false);
+
     int version() const;
     void setVersion(int ver);
 
@@ -93,9 +119,22 @@ public:
     void copyDock(Plasma::Containment *containment);
     void recreateDock(Plasma::Containment *containment);
 
-    void syncDockViewsToScreens();
+    //! only the docks affected by the screens delta are added, deleted or
+    //! reconsidered, by default all of them are checked
+    void syncDockViewsToScreens(const ScreenTopology::Delta &delta = ScreenTopology::Delta::fullDelta());
     void importToCorona();
 
+    //! the docks of the containments that are added until commitStagedDocks()
+    //! are not created immediately. The most important dock is created first
+    //! and the others one at a time after the first frame of the previous one
+    void beginStagedDocks();
+    //! priorityContainmentId is the dock with tasks that must be shown first,
+    //! when it is -1 the first dock with tasks on primary screen is chosen
+    void commitStagedDocks(int priorityContainmentId = -1, bool forcePriorityDock = false);
+    bool hasStagedDocks() const;
+
+    static bool containsTasks(Plasma::Containment *containment);
+
     const QStringList appliedActivities();
 
     QList<Plasma::Containment *> *containments();
@@ -118,6 +157,8 @@ signals:
     void nameChanged();
     void versionChanged();
     void showInMenuChanged();
+    void standbyChanged();
+    void stagedDocksFinished();
 
 private slots:
     void loadConfig();
@@ -128,6 +169,7 @@ private slots:
     void destroyedChanged(bool destroyed);
     void containmentDestroyed(QObject *cont);
     void updateLastUsedActivity();
+    void addNextStagedDock();
 
 private:
     void importLocalLayout(QString file);
@@ -135,7 +177,24 @@ private:
     void setName(QString name);
     void setFile(QString file);
 
-    QString availableId(QStringList all, QStringList assigned, int base);
+    //! sha1 digest of the group entries and subgroups, it is used in order to
+    //! write only the changed containments and applets to the layout file
+    QByteArray groupDigest(const KConfigGroup &group, bool skipApplets = false) const;
+
+    //! returns the first id not used in the bitmap starting from the cursor,
+    //! the id is marked as used and the cursor moves after it
+    static QString availableId(QBitArray &usedIds, int &cursor);
+    static void markUsedId(QBitArray &usedIds, int id);
+    //! bitmap of the containment and applet ids loaded in the corona
+    static QBitArray coronaUsedIds(DockCorona *corona);
+    //! old id -> new unique id for the containments and their applets
+    static QHash<QString, QString> assignUniqueIds(const KConfigGroup &containments, const QStringList &containmentIds, QBitArray &usedIds);
+    //! copies the containments to target with their assigned ids, the applet orders
+    //! and the systray ids are updated. An empty layoutId is not written.
+    //! They are static and they do not touch the corona, so they can be used
+    //! also from worker threads
+    static void copyContainmentsWithIds(const KConfigGroup &containments, const QStringList &containmentIds,
+                                        const QHash<QString, QString> &assigned, const QString &layoutId, KConfigGroup &target);
     //! provides a new file path based the provided file. The new file
     //! has updated ids for containments and applets based on the corona
     //! loaded ones
@@ -143,8 +202,24 @@ private:
     //! imports a layout file and returns the containments for the docks
     QList<Plasma::Containment *> importLayoutFile(QString file);
 
+    struct DockPlacement {
+        bool onPrimary{true};
+        Plasma::Types::Location location{Plasma::Types::BottomEdge};
+        QString connector;
+    };
+
+    DockPlacement dockPlacement(Plasma::Containment *containment) const;
+
+    int stagedDockPriority(Plasma::Containment *containment) const;
+    void clearStagedDocks();
+
 private:
     bool m_showInMenu{false};
+    bool m_materialized{true};
+    bool m_standby{false};
+    bool m_stagedLoading{false};
+    bool m_forcePriorityDock{false};
+    int m_priorityContainmentId{-1};
     //if version doesnt exist it is and old layout file
     int m_version{2};
 
@@ -157,6 +232,11 @@ private:
 
     QStringList m_unloadedContainmentsIds;
 
+    //! containment id or containmentId/appletId -> digest when it was last
+    //! written to the layout file
+    QHash<QString, QByteArray> m_syncedDigests;
+    QDateTime m_syncedFileTime;
+
     DockCorona *m_corona{nullptr};
     KConfigGroup m_layoutGroup;
 
@@ -164,6 +244,15 @@ private:
 
     QHash<const Plasma::Containment *, DockView *> m_dockViews;
     QHash<const Plasma::Containment *, DockView *> m_waitingDockViews;
+
+    //! containments whose docks are waiting to be created, in priority order
+    QList<QPointer<Plasma::Containment>> m_stagedDocks;
+    //! fallback for docks that are not painted e.g. hidden ones
+    QTimer m_stagedDocksTimer;
+    //! the first frame of the last staged dock starts the next one
+    QMetaObject::Connection m_stagedDockFrameConnection;
+
+    friend class LayoutManager;
 };
 
 }
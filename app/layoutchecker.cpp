@@ -0,0 +1,226 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "layoutchecker.h"
+
+#include <QFile>
+#include <QSet>
+
+#include <KConfig>
+#include <KLocalizedString>
+
+namespace Latte {
+
+LayoutChecker::LayoutChecker()
+{
+}
+
+void LayoutChecker::addFile(const QString &file)
+{
+    if (!QFile::exists(file)) {
+        return;
+    }
+
+    KConfig config(file, KConfig::SimpleConfig);
+    addContainments(KConfigGroup(&config, "Containments"));
+}
+
+void LayoutChecker::addContainments(const KConfigGroup &containmentsGroup)
+{
+    foreach (auto cId, containmentsGroup.groupList()) {
+        addContainment(containmentsGroup.group(cId));
+    }
+}
+
+void LayoutChecker::addContainment(const KConfigGroup &containmentGroup)
+{
+    m_resolved = false;
+
+    QString cId = containmentGroup.name();
+    markId(cId, i18nc("layout checker", "containment %0").arg(cId));
+
+    if (containmentGroup.readEntry("plugin", QString()) == QLatin1String("org.kde.plasma.private.systemtray")) {
+        m_systrays << cId;
+    }
+
+    KConfigGroup appletsGroup = containmentGroup.group("Applets");
+    QStringList applets = appletsGroup.groupList();
+    m_applets[cId] = applets;
+
+    foreach (auto aId, applets) {
+        markId(aId, i18nc("layout checker", "applet %0 of containment %1").arg(aId).arg(cId));
+
+        int systrayId = appletsGroup.group(aId).group("Configuration").readEntry("SystrayContainmentId", -1);
+
+        if (systrayId != -1) {
+            Reference reference;
+            reference.type = DanglingSystray;
+            reference.containmentId = cId;
+            reference.appletId = aId;
+            reference.targetId = QString::number(systrayId);
+            m_references << reference;
+        }
+    }
+
+    KConfigGroup general = containmentGroup.group("General");
+
+    foreach (auto type, QList<IssueType>({DanglingAppletOrder, DanglingLockedZoomApplet})) {
+        QString setting = (type == DanglingAppletOrder) ? "appletOrder" : "lockedZoomApplets";
+
+        foreach (auto aId, general.readEntry(setting, QString()).split(";", QString::SkipEmptyParts)) {
+            Reference reference;
+            reference.type = type;
+            reference.containmentId = cId;
+            reference.targetId = aId;
+            m_references << reference;
+        }
+    }
+}
+
+void LayoutChecker::markId(const QString &id, const QString &location)
+{
+    bool ok{false};
+    int numericId = id.toInt(&ok);
+
+    if (ok) {
+        m_usedIds.insert(numericId);
+    }
+
+    if (!m_locations.contains(id)) {
+        m_locations[id] = location;
+        return;
+    }
+
+    Issue issue;
+    issue.type = DuplicateId;
+    issue.id = id;
+    issue.description = i18nc("layout checker", "Id %0 of %1 is already used by %2").arg(id).arg(location).arg(m_locations[id]);
+    //! the suggestion is found when the references are resolved, all the ids must be known
+    m_duplicates << issue;
+}
+
+void LayoutChecker::resolve()
+{
+    if (m_resolved) {
+        return;
+    }
+
+    m_resolved = true;
+    m_issues.clear();
+
+    //! free ids for the duplicates are found by a cursor that only moves forward
+    QSet<int> usedIds = m_usedIds;
+    int cursor{0};
+
+    foreach (auto issue, m_duplicates) {
+        cursor = qMax(cursor, issue.id.toInt());
+
+        while (usedIds.contains(cursor)) {
+            ++cursor;
+        }
+
+        usedIds.insert(cursor);
+        issue.suggestion = i18nc("layout checker", "assign the free id %0 to the second one").arg(cursor);
+        m_issues << issue;
+    }
+
+    QHash<QString, int> systrayReferences;
+
+    //! the applets of each containment are hashed once, only when they are referenced
+    QHash<QString, QSet<QString>> appletsSets;
+
+    foreach (auto reference, m_references) {
+        Issue issue;
+        issue.type = reference.type;
+        issue.id = reference.targetId;
+        issue.containmentId = reference.containmentId;
+
+        if (reference.type == DanglingSystray) {
+            systrayReferences[reference.targetId]++;
+
+            if (m_applets.contains(reference.targetId)) {
+                continue;
+            }
+
+            issue.description = i18nc("layout checker", "Systray applet %0 of containment %1 points to the missing containment %2")
+                                .arg(reference.appletId).arg(reference.containmentId).arg(reference.targetId);
+            issue.suggestion = i18nc("layout checker", "remove the applet %0 or its SystrayContainmentId entry").arg(reference.appletId);
+        } else {
+            if (!appletsSets.contains(reference.containmentId)) {
+                appletsSets[reference.containmentId] = QSet<QString>::fromList(m_applets.value(reference.containmentId));
+            }
+
+            if (appletsSets[reference.containmentId].contains(reference.targetId)) {
+                continue;
+            }
+
+            QString setting = (reference.type == DanglingAppletOrder) ? "appletOrder" : "lockedZoomApplets";
+            issue.description = i18nc("layout checker", "%0 of containment %1 contains the missing applet %2")
+                                .arg(setting).arg(reference.containmentId).arg(reference.targetId);
+            issue.suggestion = i18nc("layout checker", "remove %0 from %1").arg(reference.targetId).arg(setting);
+        }
+
+        m_issues << issue;
+    }
+
+    foreach (auto systray, m_systrays) {
+        if (!systrayReferences.contains(systray)) {
+            Issue issue;
+            issue.type = OrphanedContainment;
+            issue.id = systray;
+            issue.containmentId = systray;
+            issue.description = i18nc("layout checker", "Systray containment %0 is not used by any applet").arg(systray);
+            issue.suggestion = i18nc("layout checker", "remove the containment %0").arg(systray);
+            m_issues << issue;
+        }
+    }
+}
+
+QList<LayoutChecker::Issue> LayoutChecker::issues()
+{
+    resolve();
+    return m_issues;
+}
+
+bool LayoutChecker::hasDuplicateIds() const
+{
+    return !m_duplicates.isEmpty();
+}
+
+bool LayoutChecker::isValid()
+{
+    resolve();
+    return m_issues.isEmpty();
+}
+
+QStringList LayoutChecker::report()
+{
+    resolve();
+
+    QStringList lines;
+
+    foreach (auto issue, m_issues) {
+        lines << issue.description + " :: " + i18nc("layout checker", "suggestion: %0").arg(issue.suggestion);
+    }
+
+    return lines;
+}
+
+}
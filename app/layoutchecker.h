@@ -0,0 +1,104 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTCHECKER_H
+#define LAYOUTCHECKER_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <KConfigGroup>
+
+namespace Latte {
+
+//! This class validates the containments of a layout in one pass. The ids are
+//! tracked in hashes, so large layout files are checked in linear time. It
+//! reports duplicate ids, orphaned containments and dangling references of
+//! the systrays, the applets order and the locked zoom applets together with
+//! a repair suggestion for each one of them.
+class LayoutChecker {
+public:
+    enum IssueType {
+        DuplicateId = 0,
+        OrphanedContainment,
+        DanglingSystray,
+        DanglingAppletOrder,
+        DanglingLockedZoomApplet
+    };
+
+    struct Issue {
+        IssueType type{DuplicateId};
+        QString id;
+        QString containmentId;
+        QString description;
+        QString suggestion;
+    };
+
+    LayoutChecker();
+
+    //! checks all the containments of a layout file
+    void addFile(const QString &file);
+    //! checks all the subgroups of a Containments group
+    void addContainments(const KConfigGroup &containmentsGroup);
+    void addContainment(const KConfigGroup &containmentGroup);
+
+    //! the issues found after resolving the references of the added containments,
+    //! containments added afterwards lead to a new resolution
+    QList<Issue> issues();
+
+    bool hasDuplicateIds() const;
+    bool isValid();
+
+    //! a human readable report, one line per issue
+    QStringList report();
+
+private:
+    struct Reference {
+        IssueType type{DanglingSystray};
+        QString containmentId;
+        QString appletId;
+        QString targetId;
+    };
+
+    void markId(const QString &id, const QString &location);
+    void resolve();
+
+private:
+    bool m_resolved{false};
+
+    QList<Issue> m_duplicates;
+    QList<Issue> m_issues;
+    QList<Reference> m_references;
+
+    //! id -> where it was found first
+    QHash<QString, QString> m_locations;
+    //! containment id -> its applets
+    QHash<QString, QStringList> m_applets;
+    QStringList m_systrays;
+
+    QSet<int> m_usedIds;
+};
+
+}
+
+#endif // LAYOUTCHECKER_H
@@ -21,7 +21,9 @@
 
 #include "ui_layoutconfigdialog.h"
 #include "layoutconfigdialog.h"
+#include "archiveinspector.h"
 #include "layout.h"
+#include "layoutpack.h"
 #include "layoutsDelegates/checkboxdelegate.h"
 #include "layoutsDelegates/colorcmbboxdelegate.h"
 #include "layoutsDelegates/activitycmbboxdelegate.h"
@@ -38,9 +40,6 @@
 #include <QTemporaryDir>
 
 #include <KActivities/Controller>
-#include <KArchive/KTar>
-#include <KArchive/KArchiveEntry>
-#include <KArchive/KArchiveDirectory>
 #include <KLocalizedString>
 #include <KNotification>
 #include <KNewStuff3/KNS3/DownloadDialog>
@@ -301,7 +300,8 @@ void LayoutConfigDialog::on_importButton_clicked()
 
     QStringList filters;
     filters << QString(i18nc("import latte layout", "Latte Dock Layout file v0.2") + "(*.layout.latte)")
-            << QString(i18nc("import latte layouts/configuration", "Latte Dock Full Configuration file (v0.1, v0.2)") + "(*.latterc)");
+            << QString(i18nc("import latte layouts/configuration", "Latte Dock Full Configuration file (v0.1, v0.2)") + "(*.latterc)")
+            << QString(i18nc("import latte layouts package", "Latte Dock Layouts Package v0.3") + "(*.lattepack)");
     fileDialog->setNameFilters(filters);
 
     connect(fileDialog, &QFileDialog::finished
@@ -314,6 +314,12 @@ void LayoutConfigDialog::on_importButton_clicked()
 
         if (version == Importer::LayoutVersion2) {
             addLayoutForFile(file);
+        } else if (version == Importer::LayoutsPackVersion1) {
+            QDir tempDir{uniqueTempDirectory()};
+
+            foreach (auto layoutFile, LayoutPack::extractLayouts(file, tempDir.absolutePath())) {
+                addLayoutForFile(layoutFile, Layout::layoutName(layoutFile), false);
+            }
         } else if (version == Importer::ConfigVersion1) {
             auto msg = new QMessageBox(this);
             msg->setIcon(QMessageBox::Warning);
@@ -376,19 +382,13 @@ void LayoutConfigDialog::on_importButton_clicked()
 
 bool LayoutConfigDialog::importLayoutsFromV1ConfigFile(QString file)
 {
-    KTar archive(file, QStringLiteral("application/x-tar"));
-    archive.open(QIODevice::ReadOnly);
+    ArchiveInspector inspector(file);
 
-    //! if the file isnt a tar archive
-    if (archive.isOpen()) {
+    //! if the file isnt a valid old configuration archive
+    if (inspector.version() == Importer::ConfigVersion1) {
         QDir tempDir{uniqueTempDirectory()};
 
-        const auto archiveRootDir = archive.directory();
-
-        foreach (auto &name, archiveRootDir->entries()) {
-            auto fileEntry = archiveRootDir->file(name);
-            fileEntry->copyTo(tempDir.absolutePath());
-        }
+        inspector.extractTo(tempDir.absolutePath());
 
         QString name = Importer::nameOfConfigFile(file);
 
@@ -439,9 +439,11 @@ void LayoutConfigDialog::on_exportButton_clicked()
     QStringList filters;
     QString filter1(i18nc("export layout", "Latte Dock Layout file v0.2") + "(*.layout.latte)");
     QString filter2(i18nc("export full configuraion", "Latte Dock Full Configuration file v0.2") + "(*.latterc)");
+    QString filter3(i18nc("export layouts package", "Latte Dock Layouts Package v0.3") + "(*.lattepack)");
 
     filters << filter1
-            << filter2;
+            << filter2
+            << filter3;
 
     fileDialog->setNameFilters(filters);
 
@@ -480,6 +482,22 @@ void LayoutConfigDialog::on_exportButton_clicked()
                 QDesktopServices::openUrl({QFileInfo(file).canonicalPath()});
             });
 
+            notification->sendEvent();
+        } else if (file.endsWith(".lattepack")) {
+            if (!LayoutPack::exportLayouts({layoutExported}, file)) {
+                showNotificationError();
+                return;
+            }
+
+            auto notification = new KNotification("export-done", KNotification::CloseOnTimeout);
+            notification->setActions({i18nc("export layout", "Open location")});
+            notification->setText(i18nc("export layout", "Layout exported successfully"));
+
+            connect(notification, &KNotification::action1Activated
+            , this, [file]() {
+                QDesktopServices::openUrl({QFileInfo(file).canonicalPath()});
+            });
+
             notification->sendEvent();
         } else if (file.endsWith(".latterc")) {
             auto showNotificationError = []() {
@@ -19,17 +19,28 @@
 */
 
 #include "layoutmanager.h"
+#include "configsyncer.h"
 #include "infoview.h"
+#include "memoryaccounting.h"
 #include "screenpool.h"
+#include "startuptracer.h"
 
 #include <QDir>
 #include <QFile>
 #include <QMessageBox>
 #include <QQmlProperty>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 #include <QtDBus/QtDBus>
 
+#include <functional>
+
 #include <KActivities/Consumer>
 #include <KActivities/Controller>
+#include <KConfig>
 #include <KLocalizedString>
 #include <KNotification>
 
@@ -37,6 +48,23 @@ namespace Latte {
 
 const int MultipleLayoutsPresetId = 10;
 
+//! a job of the layouts loading pipeline that runs on a worker thread
+class LayoutLoadTask : public QRunnable {
+public:
+    LayoutLoadTask(std::function<void()> job)
+        : m_job(job)
+    {
+    }
+
+    void run() override
+    {
+        m_job();
+    }
+
+private:
+    std::function<void()> m_job;
+};
+
 LayoutManager::LayoutManager(QObject *parent)
     : QObject(parent),
       m_importer(new Importer(this)),
@@ -58,6 +86,11 @@ LayoutManager::LayoutManager(QObject *parent)
         m_dynamicSwitchTimer.setSingleShot(true);
         showInfoWindowChanged();
         connect(&m_dynamicSwitchTimer, &QTimer::timeout, this, &LayoutManager::confirmDynamicSwitch);
+
+        //! idle background layouts are checked once per minute
+        m_lazyLayoutsTimer.setInterval(60 * 1000);
+        connect(&m_lazyLayoutsTimer, &QTimer::timeout, this, &LayoutManager::dematerializeIdleLayouts);
+        connect(m_corona->universalSettings(), &UniversalSettings::lazyLayoutsTimeoutChanged, this, &LayoutManager::updateLayoutsIdleState);
     }
 }
 
@@ -107,6 +140,9 @@ void LayoutManager::load()
 
     qDebug() << "Latte is loading  its layouts...";
 
+    //! the docks are loaded for the current screens
+    m_screenTopology.update();
+
     connect(m_corona->m_activityConsumer, &KActivities::Consumer::currentActivityChanged,
             this, &LayoutManager::currentActivityChanged);
 
@@ -122,10 +158,14 @@ void LayoutManager::load()
 
 void LayoutManager::unload()
 {
+    unloadStandbyLayouts();
+
     //! Unload all Layouts
     foreach (auto layout, m_activeLayouts) {
         if (memoryUsage() == Dock::MultipleLayouts && layout->isOriginalLayout()) {
             layout->syncToLayoutFile();
+        } else if (memoryUsage() == Dock::SingleLayout) {
+            layout->syncDetachedContainmentsToLayoutFile(true);
         }
 
         layout->unloadContainments();
@@ -410,6 +450,278 @@ int LayoutManager::activeLayoutPos(QString id) const
     return -1;
 }
 
+QStringList LayoutManager::standbyLayoutsNames() const
+{
+    QStringList names;
+
+    foreach (auto layout, m_standbyLayouts) {
+        names << layout->name();
+    }
+
+    return names;
+}
+
+QString LayoutManager::memoryReport() const
+{
+    return MemoryAccounting::report(m_activeLayouts, m_standbyLayouts);
+}
+
+bool LayoutManager::isStandbyContainment(const Plasma::Containment *containment) const
+{
+    foreach (auto layout, m_standbyLayouts) {
+        if (layout->containments()->contains(const_cast<Plasma::Containment *>(containment))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void LayoutManager::moveActiveLayoutsToStandby()
+{
+    while (!m_activeLayouts.isEmpty()) {
+        Layout *layout = m_activeLayouts.takeFirst();
+
+        qDebug() << "STANDBY LAYOUT ::::: " << layout->name();
+
+        layout->setStandby(true);
+        m_standbyLayouts.prepend(layout);
+    }
+}
+
+bool LayoutManager::activateStandbyLayout(QString layoutName)
+{
+    Layout *layout{nullptr};
+
+    foreach (auto standby, m_standbyLayouts) {
+        if (standby->name() == layoutName) {
+            layout = standby;
+            break;
+        }
+    }
+
+    if (!layout) {
+        return false;
+    }
+
+    qDebug() << "ACTIVATING STANDBY LAYOUT ::::: " << layoutName;
+
+    m_standbyLayouts.removeAll(layout);
+    m_activeLayouts.append(layout);
+
+    layout->setStandby(false);
+    //! screens may have changed while the layout was in standby
+    layout->syncDockViewsToScreens();
+
+    return true;
+}
+
+void LayoutManager::evictStandbyLayouts(QString incomingLayoutPath)
+{
+    const int maxLayouts = m_corona->universalSettings()->standbyLayouts();
+    const qint64 budget = qint64(m_corona->universalSettings()->standbyLayoutsMemoryBudget()) * 1024 * 1024;
+
+    qint64 usage{0};
+    int kept{0};
+    QList<Layout *> evicted;
+
+    foreach (auto layout, m_standbyLayouts) {
+        const qint64 layoutUsage = layout->estimatedMemoryUsage();
+
+        if (kept >= maxLayouts || usage + layoutUsage > budget) {
+            evicted << layout;
+        } else {
+            usage += layoutUsage;
+            ++kept;
+        }
+    }
+
+    foreach (auto layout, evicted) {
+        unloadStandbyLayout(layout, incomingLayoutPath);
+    }
+}
+
+void LayoutManager::assignUniqueIdsToIncomingLayout(Layout *layout, QString layoutPath)
+{
+    if (!layout || m_standbyLayouts.isEmpty()) {
+        return;
+    }
+
+    ConfigSyncer::self()->flush();
+
+    QBitArray usedIds = Layout::coronaUsedIds(m_corona);
+
+    KSharedConfigPtr filePtr = KSharedConfig::openConfig(layoutPath);
+    KConfigGroup containments = KConfigGroup(filePtr, "Containments");
+
+    bool collides{false};
+
+    auto isUsed = [&usedIds](const QString &id) {
+        int value = id.toInt();
+        return value >= 0 && value < usedIds.size() && usedIds.testBit(value);
+    };
+
+    foreach (auto cId, containments.groupList()) {
+        if (isUsed(cId)) {
+            collides = true;
+            break;
+        }
+
+        foreach (auto aId, containments.group(cId).group("Applets").groupList()) {
+            if (isUsed(aId)) {
+                collides = true;
+                break;
+            }
+        }
+
+        if (collides) {
+            break;
+        }
+    }
+
+    if (!collides) {
+        return;
+    }
+
+    qDebug() << "INCOMING LAYOUT IDS ARE USED BY STANDBY LAYOUTS ::::: " << layout->name();
+
+    //! the new ids are stored in the layout file, it is loaded afterwards
+    QString tempFile = layout->newUniqueIdsLayoutFromFile(layoutPath);
+
+    if (tempFile.isEmpty()) {
+        return;
+    }
+
+    KSharedConfigPtr tempPtr = KSharedConfig::openConfig(tempFile);
+    KConfigGroup uniqueContainments = KConfigGroup(tempPtr, "Containments");
+
+    containments.deleteGroup();
+    uniqueContainments.copyTo(&containments);
+    filePtr->sync();
+
+    QFile(tempFile).remove();
+}
+
+void LayoutManager::unloadStandbyLayout(Layout *layout, QString incomingLayoutPath)
+{
+    if (!layout) {
+        return;
+    }
+
+    qDebug() << "REMOVING STANDBY LAYOUT ::::: " << layout->name();
+
+    m_standbyLayouts.removeAll(layout);
+
+    if (!incomingLayoutPath.isEmpty()) {
+        recycleDockViews(layout, incomingLayoutPath);
+    }
+
+    layout->syncDetachedContainmentsToLayoutFile(true);
+    layout->unloadContainments();
+    layout->unloadDockViews();
+
+    delete layout;
+}
+
+void LayoutManager::unloadStandbyLayouts()
+{
+    while (!m_standbyLayouts.isEmpty()) {
+        unloadStandbyLayout(m_standbyLayouts.first());
+    }
+}
+
+QString LayoutManager::dockSignature(const KConfigGroup &containmentGroup) const
+{
+    QString plugin = containmentGroup.readEntry("plugin", QString());
+
+    if (plugin != "org.kde.latte.containment") {
+        return QString();
+    }
+
+    int location = containmentGroup.readEntry("location", (int)Plasma::Types::BottomEdge);
+    bool onPrimary = containmentGroup.readEntry("onPrimary", true);
+    int screen = onPrimary ? -1 : containmentGroup.readEntry("lastScreen", -1);
+
+    //! the window flags are set only when the dock view is created, the
+    //! visibility mode is part of the signature in order for the struts and
+    //! the hiding of the reused window to not change
+    auto mode = static_cast<Dock::Visibility>(containmentGroup.readEntry("visibility", static_cast<int>(Dock::DodgeActive)));
+    bool dockWin{true};
+
+    if (mode != Dock::AlwaysVisible && mode != Dock::WindowsGoBelow) {
+        dockWin = containmentGroup.readEntry("dockWindowBehavior", true);
+    }
+
+    return QString::number(location) + ":" + QString::number(screen) + ":" + QString::number(mode) + ":" + QString::number(dockWin);
+}
+
+void LayoutManager::recycleDockViews(Layout *outgoing, QString incomingLayoutPath)
+{
+    if (!outgoing || incomingLayoutPath.isEmpty()) {
+        return;
+    }
+
+    KSharedConfigPtr filePtr = KSharedConfig::openConfig(incomingLayoutPath);
+    KConfigGroup incomingContainments = KConfigGroup(filePtr, "Containments");
+
+    //! signature -> incoming containments ids that have not been matched yet
+    QHash<QString, QList<uint>> incoming;
+
+    foreach (auto cId, incomingContainments.groupList()) {
+        QString signature = dockSignature(incomingContainments.group(cId));
+
+        if (!signature.isEmpty() && !m_recycledDockViews.contains(cId.toUInt())) {
+            incoming[signature].append(cId.toUInt());
+        }
+    }
+
+    if (incoming.isEmpty()) {
+        return;
+    }
+
+    QHash<const Plasma::Containment *, DockView *> *views = outgoing->dockViews();
+
+    foreach (auto containment, views->keys()) {
+        QString signature = dockSignature(containment->config());
+
+        if (signature.isEmpty() || incoming.value(signature).isEmpty()) {
+            continue;
+        }
+
+        uint incomingId = incoming[signature].takeFirst();
+        DockView *view = views->take(containment);
+
+        qDebug() << "RECYCLING DOCK VIEW ::: from containment " << containment->id() << " to containment " << incomingId;
+
+        view->releaseContainment();
+        m_recycledDockViews[incomingId] = view;
+    }
+}
+
+DockView *LayoutManager::takeRecycledDockView(const Plasma::Containment *containment)
+{
+    if (!containment) {
+        return nullptr;
+    }
+
+    return m_recycledDockViews.take(containment->id());
+}
+
+void LayoutManager::clearRecycledDockViews()
+{
+    //! the recycled docks are still useful for the docks that are not created yet
+    foreach (auto layout, m_activeLayouts) {
+        if (layout->hasStagedDocks()) {
+            connect(layout, &Layout::stagedDocksFinished, this, &LayoutManager::clearRecycledDockViews, Qt::UniqueConnection);
+            return;
+        }
+    }
+
+    //! the docks that were not matched finally, e.g. their screen is not present
+    qDeleteAll(m_recycledDockViews);
+    m_recycledDockViews.clear();
+}
+
 void LayoutManager::updateCurrentLayoutNameInMultiEnvironment()
 {
     foreach (auto layout, m_activeLayouts) {
@@ -438,6 +750,8 @@ void LayoutManager::currentActivityChanged(const QString &id)
 
         m_dynamicSwitchTimer.start();
     } else if (memoryUsage() == Dock::MultipleLayouts) {
+        materializeLayoutsForCurrentActivity();
+        updateLayoutsIdleState();
         updateCurrentLayoutNameInMultiEnvironment();
     }
 }
@@ -491,6 +805,9 @@ void LayoutManager::confirmDynamicSwitch()
 
 void LayoutManager::loadLayouts()
 {
+    //! the layout files are read from disk
+    ConfigSyncer::self()->flush();
+
     m_layouts.clear();
     m_menuLayouts.clear();
     m_presetsPaths.clear();
@@ -518,6 +835,13 @@ void LayoutManager::loadLayouts()
         }
     }
 
+    //! standby layouts that were removed or renamed can not be reused
+    foreach (auto layout, m_standbyLayouts) {
+        if (!m_layouts.contains(layout->name())) {
+            unloadStandbyLayout(layout);
+        }
+    }
+
     m_presetsPaths.append(m_corona->kPackage().filePath("preset1"));
     m_presetsPaths.append(m_corona->kPackage().filePath("preset2"));
     m_presetsPaths.append(m_corona->kPackage().filePath("preset3"));
@@ -529,6 +853,8 @@ void LayoutManager::loadLayouts()
 
 void LayoutManager::loadLayoutOnStartup(QString layoutName)
 {
+    StartupSpan span(QStringLiteral("LayoutManager::loadLayoutOnStartup"), {{QStringLiteral("layout"), layoutName}});
+
     if (memoryUsage() == Dock::MultipleLayouts) {
         QStringList layouts = m_importer->checkRepairMultipleLayoutsLinkedFile();
 
@@ -550,15 +876,33 @@ void LayoutManager::loadLayoutOnStartup(QString layoutName)
 
 void LayoutManager::loadLatteLayout(QString layoutPath)
 {
+    StartupSpan span(QStringLiteral("LayoutManager::loadLatteLayout"));
+
+    ConfigSyncer::self()->flush();
+
     qDebug() << " -------------------------------------------------------------------- ";
     qDebug() << " -------------------------------------------------------------------- ";
 
-    if (m_corona->containments().size() > 0) {
-        qDebug() << "LOAD LATTE LAYOUT ::: There are still containments present !!!! :: " << m_corona->containments().size();
+    int presentContainments{0};
+
+    //! containments of standby layouts remain in the corona
+    foreach (auto containment, m_corona->containments()) {
+        if (!isStandbyContainment(containment)) {
+            ++presentContainments;
+        }
     }
 
-    if (!layoutPath.isEmpty() && m_corona->containments().size() == 0) {
+    if (presentContainments > 0) {
+        qDebug() << "LOAD LATTE LAYOUT ::: There are still containments present !!!! :: " << presentContainments;
+    }
+
+    if (!layoutPath.isEmpty() && presentContainments == 0) {
         qDebug() << "LOADING CORONA LAYOUT:" << layoutPath;
+
+        foreach (auto layout, m_activeLayouts) {
+            layout->beginStagedDocks();
+        }
+
         m_corona->loadLayout(layoutPath);
 
         //! ~~~ ADDING DOCKVIEWS AND ENFORCE LOADING IF TASKS ARENT PRESENT BASED ON SCREENS ~~~ !//
@@ -573,17 +917,13 @@ void LayoutManager::loadLatteLayout(QString layoutPath)
 
         qDebug() << "TASKS WILL BE PRESENT AFTER LOADING ::: " << tasksWillBeLoaded;
 
-        foreach (auto containment, m_corona->containments()) {
-            //! forceDockLoading is used when a latte configuration based on the
-            //! current running screens does not provide a dock containing tasks.
-            //! in such case the lowest latte containment containing tasks is loaded
-            //! and it forcefully becomes primary dock
-            if (!tasksWillBeLoaded && firstContainmentWithTasks == containment->id()) {
-                tasksWillBeLoaded = true; //this protects by loading more than one dock at startup
-                addDock(containment, true);
-            } else {
-                addDock(containment);
-            }
+        //! the dock with tasks is created and shown first and the rest follow
+        //! in later frames. forceDockLoading is used when a latte configuration
+        //! based on the current running screens does not provide a dock containing
+        //! tasks. In such case the lowest latte containment containing tasks is
+        //! loaded and it forcefully becomes primary dock
+        foreach (auto layout, m_activeLayouts) {
+            layout->commitStagedDocks(firstContainmentWithTasks, !tasksWillBeLoaded);
         }
     }
 }
@@ -671,13 +1011,45 @@ bool LayoutManager::switchToLayout(QString layoutName, int previousMemoryUsage)
                 initializingMultipleLayouts = true;
             }
 
-            if (memoryUsage() == Dock::SingleLayout || initializingMultipleLayouts || previousMemoryUsage == Dock::MultipleLayouts) {
+            bool hotSwitch = memoryUsage() == Dock::SingleLayout && previousMemoryUsage == -1
+                             && m_corona->universalSettings()->standbyLayouts() > 0;
+
+            if (hotSwitch) {
+                //! the current layout is kept loaded but hidden and the requested
+                //! one is just shown if it is already in standby
+                moveActiveLayoutsToStandby();
+
+                if (!activateStandbyLayout(layoutName)) {
+                    evictStandbyLayouts(fixedLPath);
+
+                    Layout *newLayout = new Layout(this, fixedLPath, fixedLayoutName);
+                    m_activeLayouts.append(newLayout);
+                    newLayout->initToCorona(m_corona);
+
+                    assignUniqueIdsToIncomingLayout(newLayout, fixedLPath);
+
+                    loadLatteLayout(fixedLPath);
+                    clearRecycledDockViews();
+                }
+
+                evictStandbyLayouts();
+
+                emit activeLayoutsChanged();
+            } else if (memoryUsage() == Dock::SingleLayout || initializingMultipleLayouts || previousMemoryUsage == Dock::MultipleLayouts) {
+                unloadStandbyLayouts();
+
                 while (!m_activeLayouts.isEmpty()) {
                     Layout *layout = m_activeLayouts.at(0);
                     m_activeLayouts.removeFirst();
 
                     if (layout->isOriginalLayout() && previousMemoryUsage == Dock::MultipleLayouts) {
                         layout->syncToLayoutFile();
+                    } else if (previousMemoryUsage == Dock::SingleLayout || previousMemoryUsage == -1) {
+                        layout->syncDetachedContainmentsToLayoutFile(true);
+                    }
+
+                    if (memoryUsage() == Dock::SingleLayout && previousMemoryUsage == -1) {
+                        recycleDockViews(layout, fixedLPath);
                     }
 
                     layout->unloadContainments();
@@ -700,6 +1072,7 @@ bool LayoutManager::switchToLayout(QString layoutName, int previousMemoryUsage)
                 newLayout->initToCorona(m_corona);
 
                 loadLatteLayout(fixedLPath);
+                clearRecycledDockViews();
 
                 emit activeLayoutsChanged();
             }
@@ -796,6 +1169,8 @@ void LayoutManager::syncMultipleLayoutsToActivities(QString layoutForOrphans)
         }
     }
 
+    QList<Layout *> newLayouts;
+
     //! Add Layout for orphan activities
     if (!allRunningActivitiesWillBeReserved) {
         if (!activeLayout(layoutForOrphans)) {
@@ -806,7 +1181,7 @@ void LayoutManager::syncMultipleLayoutsToActivities(QString layoutForOrphans)
 
                 m_activeLayouts.append(newLayout);
                 newLayout->initToCorona(m_corona);
-                newLayout->importToCorona();
+                newLayouts << newLayout;
             }
         }
     }
@@ -820,19 +1195,231 @@ void LayoutManager::syncMultipleLayoutsToActivities(QString layoutForOrphans)
                 qDebug() << "ADDING LAYOUT ::::: " << layoutName;
                 m_activeLayouts.append(newLayout);
                 newLayout->initToCorona(m_corona);
-                newLayout->importToCorona();
-
-                if (newLayout->isOriginalLayout()) {
-                    showInfoWindow(i18n("Adding layout: <b>%0</b> ...").arg(newLayout->name()), 5000, newLayout->appliedActivities());
-                }
+                newLayouts << newLayout;
             }
         }
     }
 
+    //! the layout of the current activity is created first and in lazy mode
+    //! the layouts of the background activities keep only their settings
+    bool lazyLayouts = m_corona->universalSettings()->lazyLayouts();
+    QList<Layout *> orderedLayouts;
+
+    foreach (auto layout, newLayouts) {
+        if (layoutIsForCurrentActivity(layout)) {
+            orderedLayouts.prepend(layout);
+        } else if (lazyLayouts && layout->isOriginalLayout()) {
+            qDebug() << "LAZY LAYOUT ::::: " << layout->name();
+            layout->setMaterialized(false);
+        } else {
+            orderedLayouts.append(layout);
+        }
+    }
+
+    importLayoutsToCorona(orderedLayouts);
+
+    foreach (auto layout, orderedLayouts) {
+        if (layout->isOriginalLayout()) {
+            showInfoWindow(i18n("Adding layout: <b>%0</b> ...").arg(layout->name()), 5000, layout->appliedActivities());
+        }
+    }
+
+    updateLayoutsIdleState();
     updateCurrentLayoutNameInMultiEnvironment();
     emit activeLayoutsChanged();
 }
 
+void LayoutManager::importLayoutsToCorona(QList<Layout *> layouts)
+{
+    if (!m_corona || layouts.isEmpty()) {
+        return;
+    }
+
+    StartupSpan span(QStringLiteral("LayoutManager::importLayoutsToCorona"), {{QStringLiteral("layouts"), layouts.count()}});
+
+    ConfigSyncer::self()->flush();
+
+    struct LayoutImport {
+        Layout *layout{nullptr};
+        QString sourceFile;
+        QString targetFile;
+        QSharedPointer<KConfig> source;
+        QStringList containmentIds;
+        QHash<QString, QString> assigned;
+    };
+
+    QVector<LayoutImport> imports(layouts.count());
+
+    for (int i = 0; i < layouts.count(); ++i) {
+        imports[i].layout = layouts[i];
+        imports[i].sourceFile = layouts[i]->file();
+        imports[i].targetFile = QDir::homePath() + "/.config/lattedock.copy2." + QString::number(i) + ".bak";
+    }
+
+    QThreadPool workerPool;
+    workerPool.setMaxThreadCount(qMax(1, qMin(imports.count(), QThread::idealThreadCount())));
+
+    //! 1. the layout files are parsed and validated concurrently
+    for (int i = 0; i < imports.count(); ++i) {
+        LayoutImport *entry = &imports[i];
+
+        workerPool.start(new LayoutLoadTask([entry]() {
+            StartupSpan span(QStringLiteral("Layout::parse"), {{QStringLiteral("file"), entry->sourceFile}});
+
+            entry->source = QSharedPointer<KConfig>(new KConfig(entry->sourceFile, KConfig::SimpleConfig));
+            KConfigGroup containments(entry->source.data(), "Containments");
+
+            foreach (auto contId, containments.groupList()) {
+                //! the corona can not create a containment without its plugin
+                if (containments.group(contId).readEntry("plugin", QString()).isEmpty()) {
+                    qWarning() << "Layout loading :: containment without plugin was ignored :: " << entry->sourceFile << " : " << contId;
+                    continue;
+                }
+
+                entry->containmentIds << contId;
+            }
+        }));
+    }
+
+    workerPool.waitForDone();
+
+    //! 2. the ids are assigned in order, they depend on the corona and on the previous layouts
+    QBitArray usedIds = Layout::coronaUsedIds(m_corona);
+
+    for (int i = 0; i < imports.count(); ++i) {
+        KConfigGroup containments(imports[i].source.data(), "Containments");
+        imports[i].assigned = Layout::assignUniqueIds(containments, imports[i].containmentIds, usedIds);
+    }
+
+    //! 3. the layouts with their new ids are written concurrently
+    for (int i = 0; i < imports.count(); ++i) {
+        LayoutImport *entry = &imports[i];
+        QString layoutId = entry->layout->name();
+
+        workerPool.start(new LayoutLoadTask([entry, layoutId]() {
+            StartupSpan span(QStringLiteral("Layout::write"), {{QStringLiteral("layout"), layoutId}});
+
+            QFile targetFile(entry->targetFile);
+
+            if (targetFile.exists()) {
+                targetFile.remove();
+            }
+
+            KConfig target(entry->targetFile, KConfig::SimpleConfig);
+            KConfigGroup targetContainments(&target, "Containments");
+            KConfigGroup containments(entry->source.data(), "Containments");
+
+            Layout::copyContainmentsWithIds(containments, entry->containmentIds, entry->assigned, layoutId, targetContainments);
+
+            target.sync();
+        }));
+    }
+
+    workerPool.waitForDone();
+
+    //! 4. the containments and their docks are created in the gui thread
+    m_corona->setImmutability(Plasma::Types::Mutable);
+
+    for (int i = 0; i < imports.count(); ++i) {
+        StartupSpan span(QStringLiteral("Layout::importLayoutFile"), {{QStringLiteral("layout"), imports[i].layout->name()}});
+
+        imports[i].source.clear();
+        imports[i].layout->setMaterialized(true);
+        imports[i].layout->beginStagedDocks();
+        imports[i].layout->importLayoutFile(imports[i].targetFile);
+        imports[i].layout->commitStagedDocks();
+
+        QFile(imports[i].targetFile).remove();
+    }
+}
+
+bool LayoutManager::layoutIsForCurrentActivity(Layout *layout) const
+{
+    if (!layout) {
+        return false;
+    }
+
+    QString currentActivity = m_corona->activitiesConsumer()->currentActivity();
+
+    return layout->activities().contains(currentActivity)
+           || (layout->activities().isEmpty() && m_assignedLayouts.value(currentActivity).isEmpty());
+}
+
+void LayoutManager::materializeLayout(QString layoutName)
+{
+    Layout *layout = activeLayout(layoutName);
+
+    if (layout && !layout->isMaterialized()) {
+        qDebug() << "MATERIALIZING LAYOUT ::::: " << layoutName;
+        importLayoutsToCorona({layout});
+        updateLayoutsIdleState();
+    }
+}
+
+void LayoutManager::materializeLayoutsForCurrentActivity()
+{
+    QList<Layout *> layouts;
+
+    foreach (auto layout, m_activeLayouts) {
+        if (!layout->isMaterialized() && layoutIsForCurrentActivity(layout)) {
+            qDebug() << "MATERIALIZING LAYOUT ::::: " << layout->name();
+            layouts << layout;
+        }
+    }
+
+    importLayoutsToCorona(layouts);
+}
+
+void LayoutManager::updateLayoutsIdleState()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QHash<QString, QDateTime> idleSince;
+
+    if (memoryUsage() == Dock::MultipleLayouts) {
+        foreach (auto layout, m_activeLayouts) {
+            if (layout->isOriginalLayout() && layout->isMaterialized() && !layoutIsForCurrentActivity(layout)) {
+                idleSince[layout->name()] = m_layoutsIdleSince.value(layout->name(), now);
+            }
+        }
+    }
+
+    m_layoutsIdleSince = idleSince;
+
+    if (m_corona->universalSettings()->lazyLayouts() && m_corona->universalSettings()->lazyLayoutsTimeout() > 0
+        && !m_layoutsIdleSince.isEmpty()) {
+        if (!m_lazyLayoutsTimer.isActive()) {
+            m_lazyLayoutsTimer.start();
+        }
+    } else {
+        m_lazyLayoutsTimer.stop();
+    }
+}
+
+void LayoutManager::dematerializeIdleLayouts()
+{
+    int timeout = m_corona->universalSettings()->lazyLayoutsTimeout() * 60;
+    QDateTime now = QDateTime::currentDateTime();
+
+    if (memoryUsage() == Dock::MultipleLayouts && timeout > 0) {
+        foreach (auto layout, m_activeLayouts) {
+            if (!m_layoutsIdleSince.contains(layout->name()) || layoutIsForCurrentActivity(layout)
+                || m_layoutsIdleSince[layout->name()].secsTo(now) < timeout) {
+                continue;
+            }
+
+            qDebug() << "DEMATERIALIZING LAYOUT ::::: " << layout->name();
+
+            layout->syncToLayoutFile();
+            layout->unloadContainments();
+            layout->unloadDockViews();
+            clearUnloadedContainmentsFromLinkedFile(layout->unloadedContainmentsIds());
+            layout->setMaterialized(false);
+        }
+    }
+
+    updateLayoutsIdleState();
+}
+
 void LayoutManager::syncActiveLayoutsToOriginalFiles()
 {
     if (memoryUsage() == Dock::MultipleLayouts) {
@@ -855,17 +1442,24 @@ void LayoutManager::clearUnloadedContainmentsFromLinkedFile(QStringList containm
     foreach (auto conId, containmentsIds) {
         qDebug() << "unloads ::: " << conId;
         KConfigGroup containment = containments.group(conId);
-        containment.deleteGroup();
+        ConfigSyncer::self()->deleteGroup(containment);
     }
-
-    containments.sync();
 }
 
 
 void LayoutManager::syncDockViewsToScreens()
 {
+    //! the delta is computed once for all the layouts, repeated signals
+    //! of the same screens change produce an empty delta
+    ScreenTopology::Delta delta = m_screenTopology.update();
+
+    if (delta.isEmpty()) {
+        qDebug() << "screens topology has not changed...";
+        return;
+    }
+
     foreach (auto layout, m_activeLayouts) {
-        layout->syncDockViewsToScreens();
+        layout->syncDockViewsToScreens(delta);
     }
 }
 
@@ -900,6 +1494,10 @@ QString LayoutManager::newLayout(QString layoutName, QString preset)
 bool LayoutManager::heuresticForLoadingDockWithTasks(int *firstContainmentWithTasks)
 {
     foreach (auto containment, m_corona->containments()) {
+        if (isStandbyContainment(containment)) {
+            continue;
+        }
+
         QString plugin = containment->pluginMetaData().pluginId();
 
         if (plugin == "org.kde.latte.containment") {
@@ -909,18 +1507,7 @@ bool LayoutManager::heuresticForLoadingDockWithTasks(int *firstContainmentWithTa
             qDebug() << "containment values: " << onPrimary << " - " << lastScreen;
 
 
-            bool containsTasks = false;
-
-            foreach (auto applet, containment->applets()) {
-                const auto &provides = KPluginMetaData::readStringList(applet->pluginMetaData().rawData(), QStringLiteral("X-Plasma-Provides"));
-
-                if (provides.contains(QLatin1String("org.kde.plasma.multitasking"))) {
-                    containsTasks = true;
-                    break;
-                }
-            }
-
-            if (containsTasks) {
+            if (Layout::containsTasks(containment)) {
                 *firstContainmentWithTasks = containment->id();
 
                 if (onPrimary) {
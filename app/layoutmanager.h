@@ -71,6 +71,9 @@ public:
     void recreateDock(Plasma::Containment *containment);
     void syncDockViewsToScreens();
     void syncActiveLayoutsToOriginalFiles();
+    //! creates the containments and docks of a layout that is kept only
+    //! as settings, it is used before docks are moved to that layout
+    void materializeLayout(QString layoutName);
 
     bool layoutExists(QString layoutName) const;
 
@@ -95,6 +98,18 @@ public:
     Layout *activeLayout(QString id) const;
     int activeLayoutPos(QString id) const;
 
+    //! standby layouts are kept loaded but hidden in SingleLayout mode,
+    //! they are ordered from the most to the least recently used
+    QStringList standbyLayoutsNames() const;
+
+    //! JSON report of the memory that is used from the loaded layouts
+    QString memoryReport() const;
+    bool isStandbyContainment(const Plasma::Containment *containment) const;
+
+    //! returns the dock view that was kept from the previous layout for
+    //! that containment, nullptr if a new one must be created
+    DockView *takeRecycledDockView(const Plasma::Containment *containment);
+
     LaunchersSignals *launchersSignals();
 
     QStringList activities();
@@ -133,10 +148,29 @@ private slots:
     void showInfoWindowChanged();
     void showWidgetsExplorer();
     void syncMultipleLayoutsToActivities(QString layoutForOrphans = QString());
+    void dematerializeIdleLayouts();
+    void updateLayoutsIdleState();
 
 private:
     void clearUnloadedContainmentsFromLinkedFile(QStringList containmentsIds, bool bypassChecks = false);
     void confirmDynamicSwitch();
+    //! the active layout becomes the most recently used standby layout
+    void moveActiveLayoutsToStandby();
+    //! returns false when the layout is not in standby
+    bool activateStandbyLayout(QString layoutName);
+    //! unloads the least recently used standby layouts that exceed the
+    //! standby limits, their docks can be recycled for the incoming layout
+    void evictStandbyLayouts(QString incomingLayoutPath = QString());
+    //! the containments of the standby layouts remain in the corona, so the
+    //! incoming layout file gets new ids when its ids are already used
+    void assignUniqueIdsToIncomingLayout(Layout *layout, QString layoutPath);
+    void unloadStandbyLayout(Layout *layout, QString incomingLayoutPath = QString());
+    void unloadStandbyLayouts();
+    //! compares the docks of the outgoing layout with the containments of
+    //! the incoming layout file and keeps the dock views that match
+    void recycleDockViews(Layout *outgoing, QString incomingLayoutPath);
+    void clearRecycledDockViews();
+    QString dockSignature(const KConfigGroup &containmentGroup) const;
     //! it is used just in order to provide translations for the presets
     void ghostForTranslatedPresets();
     //! This function figures in the beginning if a dock with tasks
@@ -145,7 +179,11 @@ private:
     //! firstContainmentWithTasks = the first containment containing a taskmanager plasmoid
     bool heuresticForLoadingDockWithTasks(int *firstContainmentWithTasks);
     void importLatteLayout(QString layoutPath);
+    //! the layout files are parsed, validated and get their new ids on worker
+    //! threads, then their containments are created in the given order
+    void importLayoutsToCorona(QList<Layout *> layouts);
     void importPreset(int presetNo, bool newInstanceIfPresent = false);
+    void materializeLayoutsForCurrentActivity();
     void loadLatteLayout(QString layoutPath);
     void loadLayouts();
     void setMenuLayouts(QStringList layouts);
@@ -153,6 +191,9 @@ private:
     void updateCurrentLayoutNameInMultiEnvironment();
 
     bool layoutIsAssigned(QString layoutName);
+    //! the layout is assigned to the current activity or it is the layout
+    //! of the orphaned activities and the current activity is orphaned
+    bool layoutIsForCurrentActivity(Layout *layout) const;
 
     QString layoutPath(QString layoutName);
 
@@ -173,11 +214,22 @@ private:
     QHash<const QString, QString> m_assignedLayouts;
 
     QTimer m_dynamicSwitchTimer;
+    QTimer m_lazyLayoutsTimer;
+
+    //! materialized layouts of background activities -> when they became idle
+    QHash<QString, QDateTime> m_layoutsIdleSince;
 
     DockCorona *m_corona{nullptr};
     Importer *m_importer{nullptr};
     LaunchersSignals *m_launchersSignals{nullptr};
     QList<Layout *> m_activeLayouts;
+    QList<Layout *> m_standbyLayouts;
+
+    //! incoming containment id -> dock view of an unloaded layout
+    QHash<uint, DockView *> m_recycledDockViews;
+
+    //! the screens that the docks were last synced to
+    ScreenTopology m_screenTopology;
 
     KActivities::Controller *m_activitiesController;
 
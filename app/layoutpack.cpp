@@ -0,0 +1,501 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "layoutpack.h"
+
+#include "archiveinspector.h"
+#include "configserializer.h"
+#include "importer.h"
+#include "layout.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QTemporaryDir>
+
+#include <KArchive/KArchiveDirectory>
+#include <KArchive/KArchiveEntry>
+#include <KArchive/KArchiveFile>
+#include <KArchive/KTar>
+#include <KConfig>
+#include <KLocalizedString>
+
+namespace Latte {
+
+const int LayoutPack::Version = 1;
+
+namespace {
+const QString ManifestName = QStringLiteral("manifest.json");
+const QString BlobsDirectory = QStringLiteral("blobs");
+const QString PackFormat = QStringLiteral("latte-layouts-pack");
+
+//! the hashes of all the blobs that the layouts of a manifest use
+QSet<QString> blobHashes(const QJsonArray &layouts)
+{
+    QSet<QString> hashes;
+
+    foreach (auto layoutValue, layouts) {
+        QJsonObject layout = layoutValue.toObject();
+        QJsonObject settings = layout.value(QStringLiteral("settings")).toObject();
+
+        for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+            hashes << it.value().toString();
+        }
+
+        foreach (auto containmentValue, layout.value(QStringLiteral("containments")).toArray()) {
+            QJsonObject containment = containmentValue.toObject();
+            hashes << containment.value(QStringLiteral("config")).toString();
+
+            QJsonObject applets = containment.value(QStringLiteral("applets")).toObject();
+
+            for (auto it = applets.constBegin(); it != applets.constEnd(); ++it) {
+                hashes << it.value().toString();
+            }
+        }
+    }
+
+    return hashes;
+}
+
+QHash<QString, QJsonObject> containmentsById(const QJsonObject &layout)
+{
+    QHash<QString, QJsonObject> containments;
+
+    foreach (auto containmentValue, layout.value(QStringLiteral("containments")).toArray()) {
+        QJsonObject containment = containmentValue.toObject();
+        containments[containment.value(QStringLiteral("id")).toString()] = containment;
+    }
+
+    return containments;
+}
+}
+
+void LayoutPack::clearGroup(KConfigGroup &group, const QString &excludedGroup)
+{
+    foreach (auto key, group.keyList()) {
+        group.deleteEntry(key);
+    }
+
+    foreach (auto subgroup, group.groupList()) {
+        if (subgroup != excludedGroup) {
+            group.group(subgroup).deleteGroup();
+        }
+    }
+}
+
+QString LayoutPack::addBlob(const QByteArray &data, QHash<QString, QByteArray> *blobs)
+{
+    QString hash = QString::fromLatin1(ConfigSerializer::digest(data));
+
+    if (blobs && !blobs->contains(hash)) {
+        blobs->insert(hash, data);
+    }
+
+    return hash;
+}
+
+QJsonObject LayoutPack::describeLayout(KConfig *config, QHash<QString, QByteArray> *blobs)
+{
+    QJsonObject settings;
+    QStringList groups = config->groupList();
+    groups.sort();
+
+    foreach (auto groupName, groups) {
+        if (groupName == QLatin1String("Containments")) {
+            continue;
+        }
+
+        //! the activities are specific to each system
+        QStringList excludedKeys;
+
+        if (groupName == QLatin1String("LayoutSettings")) {
+            excludedKeys << QStringLiteral("activities");
+        }
+
+        QByteArray data = ConfigSerializer::groupData(KConfigGroup(config, groupName), QString(), excludedKeys);
+        settings[groupName] = addBlob(data, blobs);
+    }
+
+    QJsonArray containments;
+    KConfigGroup containmentsGroup(config, "Containments");
+
+    foreach (auto cId, containmentsGroup.groupList()) {
+        KConfigGroup containmentGroup = containmentsGroup.group(cId);
+
+        QByteArray data = ConfigSerializer::groupData(containmentGroup, QStringLiteral("Applets"));
+
+        QJsonObject applets;
+        KConfigGroup appletsGroup = containmentGroup.group("Applets");
+
+        foreach (auto aId, appletsGroup.groupList()) {
+            applets[aId] = addBlob(ConfigSerializer::groupData(appletsGroup.group(aId)), blobs);
+        }
+
+        QJsonObject containment;
+        containment[QStringLiteral("id")] = cId;
+        containment[QStringLiteral("config")] = addBlob(data, blobs);
+        containment[QStringLiteral("applets")] = applets;
+
+        containments.append(containment);
+    }
+
+    QJsonObject layout;
+    layout[QStringLiteral("settings")] = settings;
+    layout[QStringLiteral("containments")] = containments;
+
+    return layout;
+}
+
+bool LayoutPack::exportLayouts(const QStringList &layoutFiles, const QString &packFile)
+{
+    if (QFile::exists(packFile) && !QFile::remove(packFile)) {
+        return false;
+    }
+
+    KTar archive(packFile, QStringLiteral("application/x-gzip"));
+
+    if (!archive.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QHash<QString, QByteArray> blobs;
+    QJsonArray layouts;
+
+    foreach (auto file, layoutFiles) {
+        if (!QFile::exists(file)) {
+            continue;
+        }
+
+        KConfig config(file, KConfig::SimpleConfig);
+
+        QJsonObject layout = describeLayout(&config, &blobs);
+        layout[QStringLiteral("name")] = Layout::layoutName(file);
+
+        layouts.append(layout);
+    }
+
+    bool written{true};
+
+    for (auto it = blobs.constBegin(); it != blobs.constEnd(); ++it) {
+        written = written && archive.writeFile(BlobsDirectory + "/" + it.key(), it.value());
+    }
+
+    QJsonObject manifest;
+    manifest[QStringLiteral("format")] = PackFormat;
+    manifest[QStringLiteral("version")] = Version;
+    manifest[QStringLiteral("layouts")] = layouts;
+
+    written = written && archive.writeFile(ManifestName, QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+
+    archive.close();
+
+    return written;
+}
+
+QJsonObject LayoutPack::readManifest(const KArchiveDirectory *rootDir)
+{
+    if (!rootDir || !rootDir->file(ManifestName)) {
+        return QJsonObject();
+    }
+
+    QJsonObject manifest = QJsonDocument::fromJson(rootDir->file(ManifestName)->data()).object();
+
+    if (manifest.value(QStringLiteral("format")).toString() != PackFormat
+        || manifest.value(QStringLiteral("version")).toInt() != Version) {
+        return QJsonObject();
+    }
+
+    return manifest;
+}
+
+bool LayoutPack::isValid(const QString &packFile)
+{
+    KTar archive(packFile, QStringLiteral("application/x-gzip"));
+
+    if (!archive.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    return !readManifest(archive.directory()).isEmpty();
+}
+
+QStringList LayoutPack::layoutNames(const QString &packFile)
+{
+    QStringList names;
+    KTar archive(packFile, QStringLiteral("application/x-gzip"));
+
+    if (archive.open(QIODevice::ReadOnly)) {
+        foreach (auto layout, readManifest(archive.directory()).value(QStringLiteral("layouts")).toArray()) {
+            names << layout.toObject().value(QStringLiteral("name")).toString();
+        }
+    }
+
+    return names;
+}
+
+QStringList LayoutPack::extractLayouts(const QString &packFile, const QString &directory, bool reusePresentLayouts)
+{
+    QStringList files;
+    KTar archive(packFile, QStringLiteral("application/x-gzip"));
+
+    if (!archive.open(QIODevice::ReadOnly)) {
+        return files;
+    }
+
+    const KArchiveDirectory *rootDir = archive.directory();
+    QJsonObject manifest = readManifest(rootDir);
+
+    const KArchiveEntry *blobsEntry = rootDir ? rootDir->entry(BlobsDirectory) : nullptr;
+
+    if (manifest.isEmpty() || !blobsEntry || !blobsEntry->isDirectory()) {
+        qWarning() << "Layouts package :: invalid package :: " << packFile;
+        return files;
+    }
+
+    const KArchiveDirectory *blobsDir = static_cast<const KArchiveDirectory *>(blobsEntry);
+    const QJsonArray layouts = manifest.value(QStringLiteral("layouts")).toArray();
+
+    //! every blob is read and verified once before any layout file is written,
+    //! so a damaged package never leaves a partial import behind
+    QHash<QString, QByteArray> blobs;
+
+    foreach (auto hash, blobHashes(layouts)) {
+        const KArchiveFile *blobFile = blobsDir->file(hash);
+        QByteArray data = blobFile ? blobFile->data() : QByteArray();
+
+        if (!blobFile || addBlob(data, nullptr) != hash) {
+            qWarning() << "Layouts package :: missing or corrupted blob :: " << hash;
+            return files;
+        }
+
+        blobs[hash] = data;
+    }
+
+    bool toLatteDirectory = (QDir(directory) == QDir(QDir::homePath() + "/.config/latte"));
+
+    foreach (auto layoutValue, layouts) {
+        QJsonObject layout = layoutValue.toObject();
+        QString name = layout.value(QStringLiteral("name")).toString();
+
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        QString presentFile = (reusePresentLayouts && Importer::layoutExists(name)) ? Importer::layoutFilePath(name) : QString();
+        QJsonObject presentLayout;
+
+        if (!presentFile.isEmpty()) {
+            KConfig present(presentFile, KConfig::SimpleConfig);
+            presentLayout = describeLayout(&present, nullptr);
+            presentLayout[QStringLiteral("name")] = name;
+
+            //! a layout that is already present with the same content is not imported again
+            if (presentLayout == layout) {
+                qDebug() << "Layouts package :: identical layout is already present :: " << name;
+                continue;
+            }
+        }
+
+        QString fileName = toLatteDirectory ? Importer::uniqueLayoutName(name) : name;
+        QString file = directory + "/" + fileName + ".layout.latte";
+
+        if (QFile::exists(file)) {
+            QFile::remove(file);
+        }
+
+        //! the present layout is the base of the new one, its groups with
+        //! identical blobs are kept and only the differing ones are written
+        if (presentFile.isEmpty() || !QFile::copy(presentFile, file)) {
+            presentLayout = QJsonObject();
+        }
+
+        KConfig config(file, KConfig::SimpleConfig);
+
+        if (!presentLayout.isEmpty()) {
+            //! the activities are specific to the present layout
+            KConfigGroup(&config, "LayoutSettings").deleteEntry("activities");
+        }
+
+        QJsonObject settings = layout.value(QStringLiteral("settings")).toObject();
+        QJsonObject presentSettings = presentLayout.value(QStringLiteral("settings")).toObject();
+
+        foreach (auto groupName, presentSettings.keys()) {
+            if (!settings.contains(groupName)) {
+                KConfigGroup(&config, groupName).deleteGroup();
+            }
+        }
+
+        for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+            if (presentSettings.value(it.key()) == it.value()) {
+                continue;
+            }
+
+            KConfigGroup group(&config, it.key());
+            clearGroup(group, QString());
+            ConfigSerializer::readGroupData(blobs.value(it.value().toString()), group);
+        }
+
+        KConfigGroup containmentsGroup(&config, "Containments");
+        QHash<QString, QJsonObject> containments = containmentsById(layout);
+        QHash<QString, QJsonObject> presentContainments = containmentsById(presentLayout);
+
+        foreach (auto cId, presentContainments.keys()) {
+            if (!containments.contains(cId)) {
+                containmentsGroup.group(cId).deleteGroup();
+            }
+        }
+
+        for (auto it = containments.constBegin(); it != containments.constEnd(); ++it) {
+            const QJsonObject &containment = it.value();
+            QJsonObject presentContainment = presentContainments.value(it.key());
+            KConfigGroup containmentGroup = containmentsGroup.group(it.key());
+
+            if (presentContainment.value(QStringLiteral("config")) != containment.value(QStringLiteral("config"))) {
+                clearGroup(containmentGroup, QStringLiteral("Applets"));
+                ConfigSerializer::readGroupData(blobs.value(containment.value(QStringLiteral("config")).toString()), containmentGroup);
+            }
+
+            KConfigGroup appletsGroup = containmentGroup.group("Applets");
+            QJsonObject applets = containment.value(QStringLiteral("applets")).toObject();
+            QJsonObject presentApplets = presentContainment.value(QStringLiteral("applets")).toObject();
+
+            foreach (auto aId, presentApplets.keys()) {
+                if (!applets.contains(aId)) {
+                    appletsGroup.group(aId).deleteGroup();
+                }
+            }
+
+            for (auto appletIt = applets.constBegin(); appletIt != applets.constEnd(); ++appletIt) {
+                if (presentApplets.value(appletIt.key()) == appletIt.value()) {
+                    continue;
+                }
+
+                KConfigGroup appletGroup = appletsGroup.group(appletIt.key());
+                clearGroup(appletGroup, QString());
+                ConfigSerializer::readGroupData(blobs.value(appletIt.value().toString()), appletGroup);
+            }
+        }
+
+        config.sync();
+        files << file;
+    }
+
+    return files;
+}
+
+QStringList LayoutPack::roundTripIssues(const QString &file)
+{
+    if (!file.endsWith(QLatin1String(".latterc"))) {
+        return roundTripIssues(QStringList(file));
+    }
+
+    QTemporaryDir configDir;
+    ArchiveInspector inspector(file);
+    QStringList layoutFiles;
+
+    if (!configDir.isValid()) {
+        return {i18nc("layouts package", "The layouts of %0 can not be read").arg(file)};
+    }
+
+    //! the single layout of an old configuration file is its applets file
+    if (inspector.version() == Importer::ConfigVersion1) {
+        QString layoutFile = configDir.path() + "/" + Importer::nameOfConfigFile(file) + ".layout.latte";
+
+        if (!inspector.extractFilesTo({QStringLiteral("lattedock-appletsrc")}, configDir.path())
+            || !QFile::rename(configDir.path() + "/lattedock-appletsrc", layoutFile)) {
+            return {i18nc("layouts package", "The layouts of %0 can not be read").arg(file)};
+        }
+
+        return roundTripIssues(QStringList(layoutFile));
+    }
+
+    //! the layouts of a full configuration file are found in its latte directory
+    if (inspector.version() != Importer::ConfigVersion2 || !inspector.extractTo(configDir.path())) {
+        return {i18nc("layouts package", "The layouts of %0 can not be read").arg(file)};
+    }
+
+    QDir latteDir(configDir.path() + "/latte");
+
+    foreach (auto layoutFile, latteDir.entryList({QStringLiteral("*.layout.latte")}, QDir::Files | QDir::NoSymLinks)) {
+        layoutFiles << latteDir.absoluteFilePath(layoutFile);
+    }
+
+    return roundTripIssues(layoutFiles);
+}
+
+QStringList LayoutPack::roundTripIssues(const QStringList &layoutFiles)
+{
+    QTemporaryDir tempDir;
+    QString packFile = tempDir.path() + "/roundtrip.lattepack";
+    QString layoutsDirectory = tempDir.path() + "/layouts";
+
+    if (!tempDir.isValid() || !QDir(tempDir.path()).mkdir(QStringLiteral("layouts"))
+        || !exportLayouts(layoutFiles, packFile)) {
+        return {i18nc("layouts package", "The package can not be written")};
+    }
+
+    QHash<QString, QString> importedFiles;
+
+    foreach (auto importedFile, extractLayouts(packFile, layoutsDirectory, false)) {
+        importedFiles[Layout::layoutName(importedFile)] = importedFile;
+    }
+
+    QStringList issues;
+
+    foreach (auto layoutFile, layoutFiles) {
+        QString name = Layout::layoutName(layoutFile);
+
+        if (!importedFiles.contains(name)) {
+            issues << i18nc("layouts package", "Layout %0 was not imported").arg(name);
+            continue;
+        }
+
+        KConfig original(layoutFile, KConfig::SimpleConfig);
+        KConfig imported(importedFiles[name], KConfig::SimpleConfig);
+
+        QJsonObject originalLayout = describeLayout(&original, nullptr);
+        QJsonObject importedLayout = describeLayout(&imported, nullptr);
+
+        QJsonObject originalSettings = originalLayout.value(QStringLiteral("settings")).toObject();
+        QJsonObject importedSettings = importedLayout.value(QStringLiteral("settings")).toObject();
+
+        foreach (auto groupName, (originalSettings.keys() + importedSettings.keys()).toSet()) {
+            if (originalSettings.value(groupName) != importedSettings.value(groupName)) {
+                issues << i18nc("layouts package", "Group %0 of layout %1 differs").arg(groupName).arg(name);
+            }
+        }
+
+        QHash<QString, QJsonObject> originalContainments = containmentsById(originalLayout);
+        QHash<QString, QJsonObject> importedContainments = containmentsById(importedLayout);
+
+        foreach (auto cId, (originalContainments.keys() + importedContainments.keys()).toSet()) {
+            if (originalContainments.value(cId) != importedContainments.value(cId)) {
+                issues << i18nc("layouts package", "Containment %0 of layout %1 differs").arg(cId).arg(name);
+            }
+        }
+    }
+
+    return issues;
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTPACK_H
+#define LAYOUTPACK_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <KConfigGroup>
+
+class KConfig;
+class KArchiveDirectory;
+
+namespace Latte {
+
+//! This class is responsible for the compressed layouts package (.lattepack).
+//! The package is a gzip compressed tar archive that contains a manifest and
+//! blobs named by the sha1 of their content. Every layout settings group, every
+//! containment and every applet configuration is stored as a separate blob,
+//! so identical groups are stored once and they are read once on import.
+class LayoutPack {
+public:
+    static const int Version;
+
+    //! writes the layout files in a new package
+    static bool exportLayouts(const QStringList &layoutFiles, const QString &packFile);
+
+    //! writes the layouts of the package as layout files in the directory and
+    //! returns their paths. Nothing is written when a blob is missing or corrupted.
+    //! When reusePresentLayouts is set and a layout with the same name is present
+    //! in the latte directory, an identical layout is skipped and a different one
+    //! is based on the present one, so only its differing groups are written.
+    static QStringList extractLayouts(const QString &packFile, const QString &directory, bool reusePresentLayouts = true);
+
+    //! exports the layout file or the layouts of a full configuration file
+    //! (.latterc) in a package, imports them back in a temporary directory
+    //! and returns the differences that were found. It is used from the autotests
+    static QStringList roundTripIssues(const QString &file);
+
+    static bool isValid(const QString &packFile);
+    static QStringList layoutNames(const QString &packFile);
+
+private:
+    //! the manifest entry of a layout, every blob found is provided to blobs
+    static QJsonObject describeLayout(KConfig *config, QHash<QString, QByteArray> *blobs);
+    static QJsonObject readManifest(const KArchiveDirectory *rootDir);
+    static QStringList roundTripIssues(const QStringList &layoutFiles);
+
+    //! removes the entries and the subgroups of the group except excludedGroup
+    static void clearGroup(KConfigGroup &group, const QString &excludedGroup);
+    static QString addBlob(const QByteArray &data, QHash<QString, QByteArray> *blobs);
+};
+
+}
+
+#endif // LAYOUTPACK_H
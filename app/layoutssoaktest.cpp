@@ -0,0 +1,272 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "layoutssoaktest.h"
+#include "dockcorona.h"
+#include "layoutmanager.h"
+#include "memoryaccounting.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QQuickWindow>
+#include <QSet>
+#include <QTextStream>
+
+#include <KActivities/Consumer>
+#include <KActivities/Controller>
+
+namespace Latte {
+
+//! the layouts are loaded and the startup work has finished
+const int STARTDELAY = 15000;
+//! the layout switch itself is delayed for 250ms from the LayoutManager, the
+//! settle interval also lets the event loop process the deleteLater calls
+const int SETTLEINTERVAL = 1000;
+const int STEPTIMEOUT = 15000;
+
+//! the allowed growth compared to the baseline, the allocator does not
+//! always return the freed memory to the system
+const double OBJECTSTOLERANCE = 0.01;
+const double ITEMSTOLERANCE = 0.01;
+const double RESIDENTTOLERANCE = 0.10;
+const int FILEDESCRIPTORSTOLERANCE = 2;
+
+LayoutsSoakTest::LayoutsSoakTest(DockCorona *corona, int cycles, QObject *parent)
+    : QObject(parent),
+      m_cycles(qMax(cycles, 1)),
+      m_corona(corona),
+      m_activitiesController(new KActivities::Controller(this))
+{
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(SETTLEINTERVAL);
+    connect(&m_settleTimer, &QTimer::timeout, this, &LayoutsSoakTest::stepSettled);
+
+    m_stepTimeout.setSingleShot(true);
+    m_stepTimeout.setInterval(STEPTIMEOUT);
+}
+
+LayoutsSoakTest::~LayoutsSoakTest()
+{
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+void LayoutsSoakTest::start()
+{
+    QTimer::singleShot(STARTDELAY, this, &LayoutsSoakTest::begin);
+}
+
+void LayoutsSoakTest::begin()
+{
+    if (!m_corona) {
+        emit finished(false);
+        return;
+    }
+
+    LayoutManager *manager = m_corona->layoutManager();
+    m_activitiesMode = manager->memoryUsage() == Dock::MultipleLayouts;
+
+    if (m_activitiesMode) {
+        m_currentTarget = m_corona->activitiesConsumer()->currentActivity();
+        m_targets = m_corona->activitiesConsumer()->runningActivities();
+    } else {
+        m_currentTarget = manager->currentLayoutName();
+        m_targets = manager->layouts();
+    }
+
+    //! the cycles start and end at the current layout or activity
+    m_targets.removeAll(m_currentTarget);
+    m_targets.prepend(m_currentTarget);
+
+    if (m_targets.count() < 2) {
+        QTextStream(stdout) << "Latte soak test :: at least two " << (m_activitiesMode ? "running activities" : "layouts")
+                            << " are needed" << endl;
+        emit finished(false);
+        return;
+    }
+
+    connect(manager, &LayoutManager::activeLayoutsChanged, this, &LayoutsSoakTest::changeNoticed);
+    connect(manager, &LayoutManager::currentLayoutNameChanged, this, &LayoutsSoakTest::changeNoticed);
+    connect(m_corona.data(), &DockCorona::docksCountChanged, this, &LayoutsSoakTest::changeNoticed);
+
+    QTextStream(stdout) << "Latte soak test :: " << m_cycles << " cycles through " << m_targets.join(QStringLiteral(", ")) << endl;
+
+    nextStep();
+}
+
+void LayoutsSoakTest::changeNoticed()
+{
+    if (m_settleTimer.isActive()) {
+        m_settleTimer.start();
+    }
+}
+
+bool LayoutsSoakTest::targetReached() const
+{
+    if (m_activitiesMode) {
+        return m_corona->activitiesConsumer()->currentActivity() == m_currentTarget;
+    }
+
+    return m_corona->layoutManager()->currentLayoutName() == m_currentTarget;
+}
+
+void LayoutsSoakTest::nextStep()
+{
+    ++m_step;
+    m_currentTarget = m_targets.at(m_step % m_targets.count());
+
+    if (m_activitiesMode) {
+        m_activitiesController->setCurrentActivity(m_currentTarget);
+    } else {
+        m_corona->layoutManager()->switchToLayout(m_currentTarget);
+    }
+
+    m_stepTimeout.start();
+    m_settleTimer.start();
+}
+
+void LayoutsSoakTest::stepSettled()
+{
+    if (!m_corona) {
+        emit finished(false);
+        return;
+    }
+
+    if (!targetReached()) {
+        if (m_stepTimeout.isActive()) {
+            m_settleTimer.start();
+            return;
+        }
+
+        ++m_timeouts;
+        qWarning() << "Latte soak test :: switch timed out :: " << m_currentTarget;
+    }
+
+    const int stepsPerCycle = m_targets.count();
+
+    if (m_step % stepsPerCycle == 0) {
+        int cycle = m_step / stepsPerCycle;
+
+        if (cycle == 1) {
+            //! the first cycle fills the caches, the recycled docks and the standby layouts
+            m_baseline = snapshot();
+            QTextStream(stdout) << "Latte soak test :: baseline :: "
+                                << QJsonDocument::fromVariant(m_baseline.toVariantMap()).toJson(QJsonDocument::Compact) << endl;
+        } else if (cycle % 10 == 0) {
+            QTextStream(stdout) << "Latte soak test :: cycle " << (cycle - 1) << " :: "
+                                << QJsonDocument::fromVariant(snapshot().toVariantMap()).toJson(QJsonDocument::Compact) << endl;
+        }
+
+        if (cycle > m_cycles) {
+            finish();
+            return;
+        }
+    }
+
+    nextStep();
+}
+
+LayoutsSoakTest::Snapshot LayoutsSoakTest::snapshot() const
+{
+    Snapshot current;
+
+    //! every object is counted once, the windows that are part of the corona
+    //! tree are already counted with it
+    QSet<QObject *> objects = m_corona->findChildren<QObject *>().toSet();
+    objects << m_corona.data();
+
+    foreach (auto window, qGuiApp->allWindows()) {
+        if (!objects.contains(window)) {
+            objects += window->findChildren<QObject *>().toSet();
+            objects << window;
+        }
+
+        //! the visual items are counted separately, once for each window
+        if (auto quickWindow = qobject_cast<QQuickWindow *>(window)) {
+            current.items += MemoryAccounting::objectTreeUsage(quickWindow->contentItem()).items;
+        }
+    }
+
+    current.objects = objects.count();
+
+    QVariantMap process = MemoryAccounting::processReport();
+    current.windows = process.value(QStringLiteral("windows")).toInt();
+    current.fileDescriptors = process.value(QStringLiteral("fileDescriptors")).toInt();
+    current.residentBytes = process.value(QStringLiteral("residentBytes")).toLongLong();
+
+    return current;
+}
+
+QVariantMap LayoutsSoakTest::Snapshot::toVariantMap() const
+{
+    QVariantMap map;
+    map[QStringLiteral("objects")] = objects;
+    map[QStringLiteral("items")] = items;
+    map[QStringLiteral("windows")] = windows;
+    map[QStringLiteral("fileDescriptors")] = fileDescriptors;
+    map[QStringLiteral("residentBytes")] = residentBytes;
+
+    return map;
+}
+
+void LayoutsSoakTest::finish()
+{
+    Snapshot current = snapshot();
+
+    QStringList failures;
+
+    if (current.objects > m_baseline.objects * (1 + OBJECTSTOLERANCE)) {
+        failures << QStringLiteral("objects");
+    }
+
+    if (current.items > m_baseline.items * (1 + ITEMSTOLERANCE)) {
+        failures << QStringLiteral("items");
+    }
+
+    if (current.windows > m_baseline.windows) {
+        failures << QStringLiteral("windows");
+    }
+
+    if (current.fileDescriptors > m_baseline.fileDescriptors + FILEDESCRIPTORSTOLERANCE) {
+        failures << QStringLiteral("fileDescriptors");
+    }
+
+    if (current.residentBytes > m_baseline.residentBytes * (1 + RESIDENTTOLERANCE)) {
+        failures << QStringLiteral("residentBytes");
+    }
+
+    if (m_timeouts > 0) {
+        failures << QStringLiteral("timeouts");
+    }
+
+    QVariantMap report;
+    report[QStringLiteral("baseline")] = m_baseline.toVariantMap();
+    report[QStringLiteral("final")] = current.toVariantMap();
+    report[QStringLiteral("timeouts")] = m_timeouts;
+    report[QStringLiteral("failures")] = failures;
+    report[QStringLiteral("memory")] = QJsonDocument::fromJson(m_corona->memoryReport().toUtf8()).toVariant();
+
+    QTextStream(stdout) << "Latte soak test :: " << (failures.isEmpty() ? "PASSED" : "FAILED") << " :: "
+                        << QJsonDocument::fromVariant(report).toJson(QJsonDocument::Indented) << endl;
+
+    emit finished(failures.isEmpty());
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTSSOAKTEST_H
+#define LAYOUTSSOAKTEST_H
+
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
+
+namespace KActivities {
+class Controller;
+}
+
+namespace Latte {
+
+class DockCorona;
+
+//! This class switches repeatedly between the layouts, or between the running
+//! activities for MultipleLayouts, inside the running Latte instance. After a
+//! first warm up cycle it keeps a baseline of the objects, visual items,
+//! windows, file descriptors and resident memory and at the end it checks
+//! that they returned to that baseline. It is used in order to find leaks in
+//! the code paths that load and unload layouts, docks and containments. The
+//! X resources of the windows are not covered.
+class LayoutsSoakTest : public QObject {
+    Q_OBJECT
+
+public:
+    LayoutsSoakTest(DockCorona *corona, int cycles, QObject *parent = nullptr);
+    ~LayoutsSoakTest() override;
+
+    void start();
+
+signals:
+    void finished(bool passed);
+
+private slots:
+    void begin();
+    void changeNoticed();
+    void stepSettled();
+
+private:
+    struct Snapshot {
+        int objects{0};
+        int items{0};
+        int windows{0};
+        int fileDescriptors{0};
+        qint64 residentBytes{0};
+
+        QVariantMap toVariantMap() const;
+    };
+
+    Snapshot snapshot() const;
+
+    bool targetReached() const;
+    void nextStep();
+    void finish();
+
+private:
+    bool m_activitiesMode{false};
+
+    int m_cycles{0};
+    int m_step{0};
+    int m_timeouts{0};
+
+    //! layouts or activities ids, in the order they are visited
+    QStringList m_targets;
+    QString m_currentTarget;
+
+    Snapshot m_baseline;
+
+    //! a step has settled when nothing changed for a while
+    QTimer m_settleTimer;
+    QTimer m_stepTimeout;
+
+    QPointer<DockCorona> m_corona;
+    KActivities::Controller *m_activitiesController{nullptr};
+};
+
+}
+
+#endif // LAYOUTSSOAKTEST_H
@@ -21,6 +21,9 @@
 #include "dockcorona.h"
 #include "config-latte.h"
 #include "importer.h"
+#include "layoutchecker.h"
+#include "layoutssoaktest.h"
+#include "startuptracer.h"
 
 #include <memory>
 #include <csignal>
@@ -32,6 +35,7 @@
 #include <QCommandLineOption>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QLockFile>
 #include <QSharedMemory>
 
@@ -83,6 +87,7 @@ int main(int argc, char **argv)
         , {{"d", "debug"}, i18nc("command line", "Show the debugging messages on stdout.")}
         , {"default-layout", i18nc("command line", "Import and load default layout on startup.")}
         , {"available-layouts", i18nc("command line", "Print available layouts")}
+        , {"check-layout", i18nc("command line", "Check the integrity of a layout and print its issues."), i18nc("command line: check", "layout_name_or_file")}
         , {"layout", i18nc("command line", "Load specific layout on startup."), i18nc("command line: load", "layout_name")}
         , {"import-layout", i18nc("command line", "Import and load a layout."), i18nc("command line: import", "file_name")}
         , {"import-full", i18nc("command line", "Import full configuration."), i18nc("command line: import", "file_name")}
@@ -91,10 +96,16 @@ int main(int argc, char **argv)
         , {"mask", i18nc("command line" , "Show messages of debugging for the mask (Only useful to devs).")}
         , {"timers", i18nc("command line", "Show messages for debugging the timers (Only useful to devs).")}
         , {"spacers", i18nc("command line", "Show visual indicators for debugging spacers (Only useful to devs).")}
+        , {"trace-startup", i18nc("command line", "Write a trace of the startup phases in Chrome trace-event format (Only useful to devs)."), i18nc("command line: trace", "file_name")}
+        , {"soak-layouts", i18nc("command line", "Switch between the layouts or the activities many times, check for leaks and quit, X resources are not covered. It requires LATTE_SOAK_TEST=1 to be set (Only useful to devs)."), i18nc("command line: soak", "cycles")}
     });
 
     parser.process(app);
 
+    if (parser.isSet(QStringLiteral("trace-startup"))) {
+        Latte::StartupTracer::self()->start(parser.value(QStringLiteral("trace-startup")));
+    }
+
     if (parser.isSet(QStringLiteral("available-layouts"))) {
         QStringList layouts = Latte::Importer::availableLayouts();
 
@@ -112,6 +123,43 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (parser.isSet(QStringLiteral("check-layout"))) {
+        QString layout = parser.value(QStringLiteral("check-layout"));
+        QString layoutFile = QFile::exists(layout) ? layout : Latte::Importer::layoutFilePath(layout);
+
+        if (!QFile::exists(layoutFile)) {
+            qInfo() << i18nc("layout missing", "This layout doesnt exist in the system.");
+            qGuiApp->exit();
+            return 1;
+        }
+
+        Latte::LayoutChecker checker;
+        checker.addFile(layoutFile);
+
+        QStringList report = checker.report();
+
+        if (report.isEmpty()) {
+            qInfo() << i18n("No integrity issues were found in the layout.");
+        } else {
+            qInfo() << i18n("Integrity issues found in the layout:");
+
+            foreach (auto line, report) {
+                qInfo() << "     " << line;
+            }
+        }
+
+        qGuiApp->exit();
+        return report.isEmpty() ? 0 : 1;
+    }
+
+    //! the soak test switches the layouts and the activities of the running
+    //! session, so it must be requested explicitly
+    if (parser.isSet(QStringLiteral("soak-layouts")) && qgetenv("LATTE_SOAK_TEST") != "1") {
+        qInfo() << i18n("The soak test switches the layouts or the activities of the session, set LATTE_SOAK_TEST=1 in order to run it.");
+        qGuiApp->exit();
+        return 1;
+    }
+
     bool defaultLayoutOnStartup = false;
     QString layoutNameOnStartup = "";
 
@@ -204,6 +252,16 @@ int main(int argc, char **argv)
     Latte::DockCorona corona(defaultLayoutOnStartup, layoutNameOnStartup);
     KDBusService service(KDBusService::Unique);
 
+    if (parser.isSet(QStringLiteral("soak-layouts"))) {
+        auto soakTest = new Latte::LayoutsSoakTest(&corona, parser.value(QStringLiteral("soak-layouts")).toInt(), &corona);
+
+        QObject::connect(soakTest, &Latte::LayoutsSoakTest::finished, &app, [](bool passed) {
+            qGuiApp->exit(passed ? 0 : 1);
+        });
+
+        soakTest->start();
+    }
+
     return app.exec();
 }
 
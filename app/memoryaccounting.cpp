@@ -0,0 +1,236 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryaccounting.h"
+#include "dockview.h"
+#include "layout.h"
+#include "panelshadows_p.h"
+
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QQuickItem>
+#include <QWindow>
+
+#include <Plasma/Applet>
+#include <Plasma/Containment>
+
+namespace Latte {
+
+MemoryAccounting::Usage &MemoryAccounting::Usage::operator+=(const Usage &other)
+{
+    objects += other.objects;
+    items += other.items;
+    imageItems += other.imageItems;
+    imageBytes += other.imageBytes;
+    windowBytes += other.windowBytes;
+
+    return *this;
+}
+
+QVariantMap MemoryAccounting::Usage::toVariantMap() const
+{
+    QVariantMap map;
+    map[QStringLiteral("objects")] = objects;
+    map[QStringLiteral("items")] = items;
+    map[QStringLiteral("imageItems")] = imageItems;
+    map[QStringLiteral("imageBytes")] = imageBytes;
+    map[QStringLiteral("windowBytes")] = windowBytes;
+
+    return map;
+}
+
+MemoryAccounting::Usage MemoryAccounting::objectTreeUsage(QObject *root)
+{
+    Usage usage;
+
+    if (!root) {
+        return usage;
+    }
+
+    usage.objects = root->findChildren<QObject *>().count() + 1;
+
+    QQuickItem *rootItem = qobject_cast<QQuickItem *>(root);
+
+    if (!rootItem) {
+        return usage;
+    }
+
+    //! the visual tree is walked because the items of the applets are not
+    //! always children of their parent items in the objects tree
+    QList<QQuickItem *> items{rootItem};
+
+    while (!items.isEmpty()) {
+        QQuickItem *item = items.takeLast();
+        ++usage.items;
+
+        if (item->inherits("QQuickImageBase") || item->inherits("IconItem")) {
+            qreal ratio = item->window() ? item->window()->devicePixelRatio() : qGuiApp->devicePixelRatio();
+            ++usage.imageItems;
+            usage.imageBytes += qRound64(qMax(item->width(), 0.0) * ratio) * qRound64(qMax(item->height(), 0.0) * ratio) * 4;
+        }
+
+        items << item->childItems();
+    }
+
+    return usage;
+}
+
+MemoryAccounting::Usage MemoryAccounting::appletUsage(Plasma::Applet *applet)
+{
+    Usage usage;
+
+    if (!applet) {
+        return usage;
+    }
+
+    usage = objectTreeUsage(applet->property("_plasma_graphicObject").value<QObject *>());
+    usage.objects += applet->findChildren<QObject *>().count() + 1;
+
+    return usage;
+}
+
+MemoryAccounting::Usage MemoryAccounting::dockViewUsage(DockView *view)
+{
+    Usage usage;
+
+    if (!view) {
+        return usage;
+    }
+
+    //! the items of the applets are part of the dock visual tree
+    usage = objectTreeUsage(view->rootObject());
+    usage.objects += view->findChildren<QObject *>().count() + 1;
+
+    if (view->containment()) {
+        usage.objects += view->containment()->findChildren<QObject *>().count() + 1;
+    }
+
+    qreal ratio = view->devicePixelRatio();
+    usage.windowBytes = qRound64(view->width() * ratio) * qRound64(view->height() * ratio) * 4;
+
+    return usage;
+}
+
+QVariantMap MemoryAccounting::dockViewReport(DockView *view)
+{
+    QVariantMap report;
+
+    if (!view || !view->containment()) {
+        return report;
+    }
+
+    report = dockViewUsage(view).toVariantMap();
+    report[QStringLiteral("containmentId")] = view->containment()->id();
+    report[QStringLiteral("screen")] = view->currentScreen();
+    report[QStringLiteral("location")] = static_cast<int>(view->location());
+
+    QVariantList applets;
+
+    foreach (auto applet, view->containment()->applets()) {
+        QVariantMap appletReport = appletUsage(applet).toVariantMap();
+        appletReport[QStringLiteral("id")] = applet->id();
+        appletReport[QStringLiteral("plugin")] = applet->pluginMetaData().pluginId();
+
+        applets << appletReport;
+    }
+
+    report[QStringLiteral("applets")] = applets;
+
+    return report;
+}
+
+QVariantMap MemoryAccounting::layoutReport(Layout *layout)
+{
+    QVariantMap report;
+
+    if (!layout) {
+        return report;
+    }
+
+    Usage total;
+    QVariantList docks;
+
+    foreach (auto view, *layout->dockViews()) {
+        total += dockViewUsage(view);
+        docks << dockViewReport(view);
+    }
+
+    //! containments that are not shown e.g. their screen is not present
+    foreach (auto containment, *layout->containments()) {
+        if (!layout->dockViews()->contains(containment)) {
+            total.objects += containment->findChildren<QObject *>().count() + 1;
+        }
+    }
+
+    report = total.toVariantMap();
+    report[QStringLiteral("name")] = layout->name();
+    report[QStringLiteral("containments")] = layout->containments()->count();
+    report[QStringLiteral("docks")] = docks;
+
+    return report;
+}
+
+QVariantMap MemoryAccounting::processReport()
+{
+    QVariantMap report;
+
+#ifdef Q_OS_LINUX
+    QFile status(QStringLiteral("/proc/self/status"));
+
+    if (status.open(QIODevice::ReadOnly)) {
+        foreach (auto line, status.readAll().split('\n')) {
+            //! e.g. "VmRSS:     123456 kB"
+            if (line.startsWith("VmRSS:")) {
+                report[QStringLiteral("residentBytes")] = line.mid(6).simplified().split(' ').first().toLongLong() * 1024;
+                break;
+            }
+        }
+    }
+
+    report[QStringLiteral("fileDescriptors")] = QDir(QStringLiteral("/proc/self/fd")).entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).count();
+#endif
+
+    report[QStringLiteral("windows")] = qGuiApp->allWindows().count();
+    report[QStringLiteral("shadowsBytes")] = PanelShadows::self()->pixmapsCost();
+
+    return report;
+}
+
+QString MemoryAccounting::report(const QList<Layout *> &activeLayouts, const QList<Layout *> &standbyLayouts)
+{
+    QVariantList layoutReports;
+
+    foreach (auto layout, activeLayouts + standbyLayouts) {
+        QVariantMap layoutUsage = layoutReport(layout);
+        layoutUsage[QStringLiteral("standby")] = standbyLayouts.contains(layout);
+
+        layoutReports << layoutUsage;
+    }
+
+    QVariantMap report;
+    report[QStringLiteral("process")] = processReport();
+    report[QStringLiteral("layouts")] = layoutReports;
+
+    return QString::fromUtf8(QJsonDocument::fromVariant(report).toJson(QJsonDocument::Compact));
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+class QObject;
+
+namespace Plasma {
+class Applet;
+}
+
+namespace Latte {
+
+class DockView;
+class Layout;
+
+//! This class attributes the memory of Latte to its layouts, docks and
+//! applets. The QObject and QQuickItem counts are exact, the image and the
+//! window buffer sizes are estimated from the geometry of the items, which
+//! is what their pixmaps and scene graph textures occupy.
+class MemoryAccounting {
+public:
+    struct Usage {
+        int objects{0};
+        int items{0};
+        int imageItems{0};
+        //! icons and images, their pixmaps and their textures
+        qint64 imageBytes{0};
+        //! the window surface of a dock
+        qint64 windowBytes{0};
+
+        Usage &operator+=(const Usage &other);
+        QVariantMap toVariantMap() const;
+    };
+
+    static Usage objectTreeUsage(QObject *root);
+    static Usage appletUsage(Plasma::Applet *applet);
+    static Usage dockViewUsage(DockView *view);
+
+    //! the usage of the dock together with the usage of each one of its applets
+    static QVariantMap dockViewReport(DockView *view);
+    static QVariantMap layoutReport(Layout *layout);
+    //! memory that is not attributed to a layout e.g. the shadows pixmaps
+    static QVariantMap processReport();
+
+    //! a JSON document with the process usage and the usage of each layout
+    static QString report(const QList<Layout *> &activeLayouts, const QList<Layout *> &standbyLayouts);
+};
+
+}
+
+#endif // MEMORYACCOUNTING_H
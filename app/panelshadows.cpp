@@ -29,6 +29,9 @@
     #include <X11/Xatom.h>
     #include <X11/Xlib.h>
     #include <X11/Xlib-xcb.h>
+    #include <xcb/shm.h>
+    #include <sys/ipc.h>
+    #include <sys/shm.h>
     #include <fixx11h.h>
 #endif
 
@@ -48,6 +51,13 @@ public:
         , _connection(0x0),
           _gc(0x0)
         , m_isX11(KWindowSystem::isPlatformX11())
+        , m_shmChecked(false)
+        , m_shmAvailable(false)
+        , m_shmSeg(0)
+        , m_shmId(-1)
+        , m_shmData(nullptr)
+        , m_shmSize(0)
+        , m_shmOffset(0)
 #endif
     {
         setupWaylandIntegration();
@@ -57,12 +67,22 @@ public:
         // Do not call clearPixmaps() from here: it creates new QPixmap(),
         // which causes a crash when application is stopping.
         freeX11Pixmaps();
+#if HAVE_X11
+        freeShmSegment();
+#endif
     }
 
     void freeX11Pixmaps();
+#if HAVE_X11
+    bool shmAvailable();
+    bool reserveShmSegment(size_t size);
+    void freeShmSegment();
+    bool putImageShm(xcb_pixmap_t pixmap, const QImage &image);
+#endif
     void freeWaylandBuffers();
     void clearPixmaps();
     void setupPixmaps();
+    void setupWaylandBuffers();
     Qt::HANDLE createPixmap(const QPixmap &source);
     void initPixmap(const QString &element);
     QPixmap initEmptyPixmap(const QSize &size);
@@ -96,13 +116,32 @@ public:
     //! graphical context
     xcb_gcontext_t _gc;
     bool m_isX11;
+
+    //! MIT-SHM upload path, images are packed one after the other
+    //! in the segment and the server is synced only when it wraps
+    bool m_shmChecked;
+    bool m_shmAvailable;
+    xcb_shm_seg_t m_shmSeg;
+    int m_shmId;
+    uchar *m_shmData;
+    size_t m_shmSize;
+    size_t m_shmOffset;
 #endif
 
+    //! a pooled shm buffer for a shadow tile, contentHash identifies
+    //! the theme contents currently written in the buffer
+    struct WaylandTile {
+        KWayland::Client::Buffer::Ptr buffer;
+        uint contentHash = 0;
+    };
+
     struct Wayland {
         KWayland::Client::ShadowManager *manager = nullptr;
         KWayland::Client::ShmPool *shmPool = nullptr;
 
-        QList<KWayland::Client::Buffer::Ptr> shadowBuffers;
+        //! shared by all docks, kept across pixmap rebuilds and released
+        //! back to the pool only when the last window is removed
+        QList<WaylandTile> shadowTiles;
     };
     Wayland m_wayland;
 
@@ -162,6 +201,7 @@ void PanelShadows::removeWindow(const QWindow *window)
 
     if (d->m_windows.isEmpty()) {
         d->clearPixmaps();
+        d->freeWaylandBuffers();
     }
 }
 
@@ -182,6 +222,7 @@ void PanelShadows::Private::windowDestroyed(QObject *deletedObject)
 
     if (m_windows.isEmpty()) {
         clearPixmaps();
+        freeWaylandBuffers();
     }
 }
 
@@ -241,11 +282,16 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
 //
 //         return pixmap;
     QImage image(source.toImage());
-    xcb_put_image(
-        _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
-        image.width(), image.height(), 0, 0,
-        0, 32,
-        image.byteCount(), image.constBits());
+
+    //! prefer the zero-copy MIT-SHM path and fallback to the socket
+    //! when the server does not support it (e.g. remote X displays)
+    if (!putImageShm(pixmap, image)) {
+        xcb_put_image(
+            _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
+            image.width(), image.height(), 0, 0,
+            0, 32,
+            image.byteCount(), image.constBits());
+    }
 
     return (Qt::HANDLE)pixmap;
 
@@ -255,6 +301,135 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
 
 }
 
+#if HAVE_X11
+bool PanelShadows::Private::shmAvailable()
+{
+    if (m_shmChecked) {
+        return m_shmAvailable;
+    }
+
+    m_shmChecked = true;
+
+    if (!_connection) {
+        return false;
+    }
+
+    const xcb_query_extension_reply_t *extension = xcb_get_extension_data(_connection, &xcb_shm_id);
+
+    if (!extension || !extension->present) {
+        return false;
+    }
+
+    xcb_shm_query_version_cookie_t cookie = xcb_shm_query_version(_connection);
+    xcb_shm_query_version_reply_t *version = xcb_shm_query_version_reply(_connection, cookie, nullptr);
+
+    if (version) {
+        m_shmAvailable = true;
+        free(version);
+    }
+
+    return m_shmAvailable;
+}
+
+bool PanelShadows::Private::reserveShmSegment(size_t size)
+{
+    if (m_shmData && m_shmOffset + size <= m_shmSize) {
+        return true;
+    }
+
+    if (m_shmData && size <= m_shmSize) {
+        //! the segment wrapped, the server must have consumed all
+        //! the previous uploads before they are overwritten
+        free(xcb_get_input_focus_reply(_connection, xcb_get_input_focus(_connection), nullptr));
+        m_shmOffset = 0;
+        return true;
+    }
+
+    freeShmSegment();
+
+    //! shadow tiles are uploaded in groups of eight, keep room for a few of them
+    const size_t segmentSize = qMax(size * 4, size_t(64 * 1024));
+
+    m_shmId = shmget(IPC_PRIVATE, segmentSize, IPC_CREAT | 0600);
+
+    if (m_shmId < 0) {
+        return false;
+    }
+
+    void *data = shmat(m_shmId, nullptr, 0);
+
+    if (data == reinterpret_cast<void *>(-1)) {
+        shmctl(m_shmId, IPC_RMID, nullptr);
+        m_shmId = -1;
+        return false;
+    }
+
+    m_shmSeg = xcb_generate_id(_connection);
+    xcb_generic_error_t *error = xcb_request_check(_connection, xcb_shm_attach_checked(_connection, m_shmSeg, m_shmId, 0));
+
+    //! the segment is destroyed as soon as both sides detach from it
+    shmctl(m_shmId, IPC_RMID, nullptr);
+
+    if (error) {
+        free(error);
+        shmdt(data);
+        m_shmId = -1;
+        m_shmSeg = 0;
+        //! the server can not access our memory, do not try again
+        m_shmAvailable = false;
+        return false;
+    }
+
+    m_shmData = static_cast<uchar *>(data);
+    m_shmSize = segmentSize;
+    m_shmOffset = 0;
+
+    return true;
+}
+
+void PanelShadows::Private::freeShmSegment()
+{
+    if (!m_shmData) {
+        return;
+    }
+
+    if (_connection && QX11Info::display()) {
+        xcb_shm_detach(_connection, m_shmSeg);
+        xcb_flush(_connection);
+    }
+
+    shmdt(m_shmData);
+
+    m_shmData = nullptr;
+    m_shmSeg = 0;
+    m_shmId = -1;
+    m_shmSize = 0;
+    m_shmOffset = 0;
+}
+
+bool PanelShadows::Private::putImageShm(xcb_pixmap_t pixmap, const QImage &image)
+{
+    const size_t size = image.byteCount();
+
+    if (size == 0 || !shmAvailable() || !reserveShmSegment(size)) {
+        return false;
+    }
+
+    memcpy(m_shmData + m_shmOffset, image.constBits(), size);
+
+    xcb_shm_put_image(_connection, pixmap, _gc,
+                      image.width(), image.height(), 0, 0,
+                      image.width(), image.height(), 0, 0,
+                      32, XCB_IMAGE_FORMAT_Z_PIXMAP,
+                      0, m_shmSeg, m_shmOffset);
+
+    //! QImage scanlines are 32bit aligned, so are the packed offsets
+    m_shmOffset += size;
+
+    return true;
+}
+#endif
+
 void PanelShadows::Private::initPixmap(const QString &element)
 {
     m_shadowPixmaps << q->pixmap(element);
@@ -301,9 +476,53 @@ void PanelShadows::Private::setupPixmaps()
     m_emptyVerticalPix = initEmptyPixmap(QSize(1, q->elementSize(QStringLiteral("shadow-left")).height()));
     m_emptyHorizontalPix = initEmptyPixmap(QSize(q->elementSize(QStringLiteral("shadow-top")).width(), 1));
 
-    if (m_wayland.shmPool) {
-        for (auto it = m_shadowPixmaps.constBegin(); it != m_shadowPixmaps.constEnd(); ++it) {
-            m_wayland.shadowBuffers << m_wayland.shmPool->createBuffer(it->toImage());
+    setupWaylandBuffers();
+}
+
+void PanelShadows::Private::setupWaylandBuffers()
+{
+    if (!m_wayland.shmPool) {
+        return;
+    }
+
+    using namespace KWayland::Client;
+
+    for (int i = 0; i < m_shadowPixmaps.count(); ++i) {
+        const QImage image = m_shadowPixmaps.at(i).toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const uint hash = qHashBits(image.constBits(), image.byteCount());
+
+        if (i >= m_wayland.shadowTiles.count()) {
+            m_wayland.shadowTiles << WaylandTile();
+        }
+
+        WaylandTile &tile = m_wayland.shadowTiles[i];
+        QSharedPointer<Buffer> buffer = tile.buffer.toStrongRef();
+
+        if (buffer && tile.contentHash == hash && buffer->size() == image.size()) {
+            //! theme contents did not change, reuse the buffer as it is
+            continue;
+        }
+
+        if (buffer && buffer->isReleased() && buffer->size() == image.size()
+            && buffer->stride() == image.bytesPerLine()) {
+            //! the compositor is not using it, write the new contents in place
+            memcpy(buffer->address(), image.constBits(), image.byteCount());
+            tile.contentHash = hash;
+            continue;
+        }
+
+        if (buffer) {
+            buffer->setUsed(false);
+        }
+
+        tile.buffer = m_wayland.shmPool->createBuffer(image);
+        tile.contentHash = hash;
+
+        buffer = tile.buffer.toStrongRef();
+
+        if (buffer) {
+            //! keep the pool from handing it out to another tile
+            buffer->setUsed(true);
         }
     }
 }
@@ -514,14 +733,22 @@ void PanelShadows::Private::clearPixmaps()
     m_emptyVerticalPix = QPixmap();
     m_emptyHorizontalPix = QPixmap();
 #endif
-    freeWaylandBuffers();
     m_shadowPixmaps.clear();
     data.clear();
 }
 
 void PanelShadows::Private::freeWaylandBuffers()
 {
-    m_wayland.shadowBuffers.clear();
+    //! buffers are returned to the shm pool in order to be recycled
+    foreach (const WaylandTile &tile, m_wayland.shadowTiles) {
+        QSharedPointer<KWayland::Client::Buffer> buffer = tile.buffer.toStrongRef();
+
+        if (buffer) {
+            buffer->setUsed(false);
+        }
+    }
+
+    m_wayland.shadowTiles.clear();
 }
 
 void PanelShadows::Private::updateShadow(const QWindow *window, Plasma::FrameSvg::EnabledBorders enabledBorders)
@@ -566,10 +793,14 @@ void PanelShadows::Private::updateShadowWayland(const QWindow *window, Plasma::F
         return;
     }
 
-    if (m_wayland.shadowBuffers.isEmpty()) {
+    if (m_shadowPixmaps.isEmpty() || m_wayland.shadowTiles.count() < m_shadowPixmaps.count()) {
         setupPixmaps();
     }
 
+    if (m_wayland.shadowTiles.count() < 8) {
+        return;
+    }
+
     // TODO: check whether the surface already has a shadow
     KWayland::Client::Surface *surface = KWayland::Client::Surface::fromWindow(const_cast<QWindow *>(window));
 
@@ -581,46 +812,46 @@ void PanelShadows::Private::updateShadowWayland(const QWindow *window, Plasma::F
 
     //shadow-top
     if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        shadow->attachTop(m_wayland.shadowBuffers.at(0));
+        shadow->attachTop(m_wayland.shadowTiles.at(0).buffer);
     }
 
     //shadow-topright
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        shadow->attachTopRight(m_wayland.shadowBuffers.at(1));
+        shadow->attachTopRight(m_wayland.shadowTiles.at(1).buffer);
     }
 
     //shadow-right
     if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        shadow->attachRight(m_wayland.shadowBuffers.at(2));
+        shadow->attachRight(m_wayland.shadowTiles.at(2).buffer);
     }
 
     //shadow-bottomright
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        shadow->attachBottomRight(m_wayland.shadowBuffers.at(3));
+        shadow->attachBottomRight(m_wayland.shadowTiles.at(3).buffer);
     }
 
     //shadow-bottom
     if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        shadow->attachBottom(m_wayland.shadowBuffers.at(4));
+        shadow->attachBottom(m_wayland.shadowTiles.at(4).buffer);
     }
 
     //shadow-bottomleft
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        shadow->attachBottomLeft(m_wayland.shadowBuffers.at(5));
+        shadow->attachBottomLeft(m_wayland.shadowTiles.at(5).buffer);
     }
 
     //shadow-left
     if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        shadow->attachLeft(m_wayland.shadowBuffers.at(6));
+        shadow->attachLeft(m_wayland.shadowTiles.at(6).buffer);
     }
 
     //shadow-topleft
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        shadow->attachTopLeft(m_wayland.shadowBuffers.at(7));
+        shadow->attachTopLeft(m_wayland.shadowTiles.at(7).buffer);
     }
 
     QSize marginHint;
@@ -717,6 +948,25 @@ bool PanelShadows::enabled() const
     return hasElement(QStringLiteral("shadow-left"));
 }
 
+qint64 PanelShadows::pixmapsCost() const
+{
+    auto cost = [](const QPixmap &pixmap) {
+        return static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    };
+
+    qint64 shadowsCost{0};
+
+    foreach (auto pixmap, d->m_shadowPixmaps) {
+        shadowsCost += cost(pixmap);
+    }
+
+    qint64 emptyCost = cost(d->m_emptyCornerPix) + cost(d->m_emptyCornerLeftPix) + cost(d->m_emptyCornerTopPix)
+                       + cost(d->m_emptyCornerRightPix) + cost(d->m_emptyCornerBottomPix)
+                       + cost(d->m_emptyVerticalPix) + cost(d->m_emptyHorizontalPix);
+
+    return shadowsCost + emptyCost + shadowsCost * d->data.count();
+}
+
 void PanelShadows::Private::setupWaylandIntegration()
 {
     if (!KWindowSystem::isPlatformWayland()) {
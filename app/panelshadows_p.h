@@ -41,6 +41,10 @@ public:
 
     bool enabled() const;
 
+    //! the bytes of the shadow pixmaps in the client and of their copies
+    //! that are uploaded for each one of the used borders combinations
+    qint64 pixmapsCost() const;
+
 private:
     class Private;
     Private *const d;
@@ -0,0 +1,236 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "qmlcomponentcache.h"
+#include "configsyncer.h"
+#include "config-latte.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QQmlComponent>
+#include <QQmlEngine>
+
+#include <KConfigGroup>
+#include <KDeclarative/QmlObjectSharedEngine>
+#include <KPackage/Package>
+#include <KPackage/PackageLoader>
+#include <KSharedConfig>
+
+namespace Latte {
+
+//! the disk cache is prewarmed after the startup has finished
+const int DISKCACHEDELAY = 15000;
+//! pause between two compiled files, in order to not keep the gui thread busy
+const int DISKCACHEINTERVAL = 50;
+
+QmlComponentCache::QmlComponentCache(QObject *parent)
+    : QObject(parent),
+      m_sharedEngine(new KDeclarative::QmlObjectSharedEngine(this))
+{
+    m_diskCacheTimer.setSingleShot(true);
+    connect(&m_diskCacheTimer, &QTimer::timeout, this, &QmlComponentCache::compileNextFile);
+}
+
+QmlComponentCache::~QmlComponentCache()
+{
+    m_diskCacheTimer.stop();
+
+    //! the components must be released before the shared engine
+    delete m_compilingComponent.data();
+
+    foreach (auto component, m_components) {
+        delete component.data();
+    }
+
+    m_components.clear();
+
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+QQmlEngine *QmlComponentCache::engine() const
+{
+    return m_sharedEngine->engine();
+}
+
+bool QmlComponentCache::isReady(const QUrl &url) const
+{
+    auto component = m_components.value(url);
+
+    return component && component->isReady();
+}
+
+void QmlComponentCache::prewarm(const QUrl &url)
+{
+    if (!url.isValid() || m_components.contains(url) || !engine()) {
+        return;
+    }
+
+    //! the type loader compiles the file and its dependencies in its own thread,
+    //! a view that requests the same file meanwhile waits for that compilation
+    QQmlComponent *component = new QQmlComponent(engine(), url, QQmlComponent::Asynchronous, this);
+    m_components[url] = component;
+
+    if (component->isLoading()) {
+        connect(component, &QQmlComponent::statusChanged, this, &QmlComponentCache::componentStatusChanged);
+    } else {
+        componentStatusChanged();
+    }
+}
+
+QString QmlComponentCache::appletPackagePath(const QString &pluginId)
+{
+    KPackage::Package package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/Applet"), pluginId);
+
+    return package.isValid() ? package.path() : QString();
+}
+
+void QmlComponentCache::prewarmPackage(const QString &pluginId)
+{
+    KPackage::Package package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/Applet"), pluginId);
+
+    if (!package.isValid()) {
+        qDebug() << "QmlComponentCache :: package can not be prewarmed :: " << pluginId;
+        return;
+    }
+
+    prewarm(QUrl::fromLocalFile(package.filePath("mainscript")));
+}
+
+QString QmlComponentCache::diskCacheStamp(const QStringList &files)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(VERSION));
+    hash.addData(QByteArray(qVersion()));
+
+    foreach (auto file, files) {
+        hash.addData(file.toUtf8());
+        hash.addData(QByteArray::number(QFileInfo(file).lastModified().toMSecsSinceEpoch()));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+void QmlComponentCache::prewarmDiskCache(const QStringList &packagePaths)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 9, 0)
+    //! the QML disk cache is available since Qt 5.9
+    Q_UNUSED(packagePaths);
+    return;
+#else
+
+    if (qEnvironmentVariableIsSet("QML_DISABLE_DISK_CACHE")) {
+        return;
+    }
+
+    QStringList files;
+
+    foreach (auto path, packagePaths) {
+        if (path.isEmpty()) {
+            continue;
+        }
+
+        QDirIterator it(path, {QStringLiteral("*.qml")}, QDir::Files, QDirIterator::Subdirectories);
+
+        while (it.hasNext()) {
+            files << it.next();
+        }
+    }
+
+    files.sort();
+
+    QString stamp = diskCacheStamp(files);
+    KConfigGroup group(KSharedConfig::openConfig(), "QmlCache");
+
+    if (files.isEmpty() || group.readEntry("diskCacheStamp", QString()) == stamp) {
+        return;
+    }
+
+    qDebug() << "QmlComponentCache :: files to compile for the disk cache :: " << files.count();
+
+    m_diskCacheStamp = stamp;
+    m_filesToCompile = files;
+    m_diskCacheTimer.start(DISKCACHEDELAY);
+#endif
+}
+
+void QmlComponentCache::compileNextFile()
+{
+    if (m_compilingComponent) {
+        if (m_filesToCompile.isEmpty()) {
+            //! the compiled types that are not used by any window are released
+            connect(m_compilingComponent.data(), &QObject::destroyed, engine(), &QQmlEngine::trimComponentCache);
+        }
+
+        //! the compiled file is already stored in the disk cache
+        m_compilingComponent->deleteLater();
+        m_compilingComponent = nullptr;
+    }
+
+    if (m_filesToCompile.isEmpty()) {
+        if (!m_diskCacheStamp.isEmpty()) {
+            KConfigGroup group(KSharedConfig::openConfig(), "QmlCache");
+            ConfigSyncer::self()->writeEntry(group, QStringLiteral("diskCacheStamp"), m_diskCacheStamp);
+            m_diskCacheStamp.clear();
+        }
+
+        return;
+    }
+
+    QUrl url = QUrl::fromLocalFile(m_filesToCompile.takeFirst());
+
+    m_compilingComponent = new QQmlComponent(engine(), url, QQmlComponent::Asynchronous, this);
+
+    if (m_compilingComponent->isLoading()) {
+        connect(m_compilingComponent.data(), &QQmlComponent::statusChanged, this, [this]() {
+            if (m_compilingComponent && !m_compilingComponent->isLoading()) {
+                m_diskCacheTimer.start(DISKCACHEINTERVAL);
+            }
+        });
+    } else {
+        m_diskCacheTimer.start(DISKCACHEINTERVAL);
+    }
+}
+
+void QmlComponentCache::componentStatusChanged()
+{
+    QMutableHashIterator<QUrl, QPointer<QQmlComponent>> i(m_components);
+
+    while (i.hasNext()) {
+        i.next();
+        QQmlComponent *component = i.value();
+
+        if (!component || !component->isError()) {
+            continue;
+        }
+
+        qWarning() << "QmlComponentCache :: " << i.key() << " :: " << component->errors();
+
+        //! a failed compilation must not remain in the type cache, the
+        //! views must compile the file on their own and report its errors
+        i.remove();
+        connect(component, &QObject::destroyed, engine(), &QQmlEngine::trimComponentCache);
+        component->deleteLater();
+    }
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QMLCOMPONENTCACHE_H
+#define QMLCOMPONENTCACHE_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+
+class QQmlComponent;
+class QQmlEngine;
+
+namespace KDeclarative {
+class QmlObjectSharedEngine;
+}
+
+namespace Latte {
+
+//! All the DockViews are QuickViewSharedEngine windows and the applets are
+//! loaded through QmlObjectSharedEngine, so they already share one QQmlEngine
+//! and its type cache. That engine is destroyed when its last user is gone,
+//! e.g. while switching layouts, and the first dock compiles its QML files
+//! synchronously. This class keeps the shared engine alive for the lifetime
+//! of the corona and compiles the main QML files of the dock, the containment
+//! and the tasks plasmoid asynchronously in advance. The compiled components
+//! remain referenced, so every dock is instantiated from the type cache.
+class QmlComponentCache : public QObject {
+    Q_OBJECT
+
+public:
+    QmlComponentCache(QObject *parent = nullptr);
+    ~QmlComponentCache() override;
+
+    QQmlEngine *engine() const;
+
+    //! the file is compiled asynchronously, it is ignored if it is already cached
+    void prewarm(const QUrl &url);
+    //! the main QML files of the Latte applet packages
+    void prewarmPackage(const QString &pluginId);
+
+    bool isReady(const QUrl &url) const;
+
+    //! every QML file of the given package directories is compiled one at a
+    //! time when Latte is idle. Qt stores the compiled files in its disk cache,
+    //! so the settings windows and the new docks load without compiling. The
+    //! work is skipped when the packages have not changed since the last time
+    void prewarmDiskCache(const QStringList &packagePaths);
+
+    static QString appletPackagePath(const QString &pluginId);
+
+private slots:
+    void componentStatusChanged();
+    void compileNextFile();
+
+private:
+    //! Latte and Qt versions and the paths and modification times of the files
+    static QString diskCacheStamp(const QStringList &files);
+
+private:
+    KDeclarative::QmlObjectSharedEngine *m_sharedEngine{nullptr};
+
+    QHash<QUrl, QPointer<QQmlComponent>> m_components;
+
+    QString m_diskCacheStamp;
+    QStringList m_filesToCompile;
+    QPointer<QQmlComponent> m_compilingComponent;
+    QTimer m_diskCacheTimer;
+};
+
+}
+
+#endif // QMLCOMPONENTCACHE_H
@@ -0,0 +1,114 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "screenhotplugcoordinator.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+
+namespace Latte {
+
+//! the period without screen changes that marks the end of a burst
+const int QUIETINTERVAL = 500;
+const int MAXIMUMWAIT = 3000;
+
+ScreenHotplugCoordinator::ScreenHotplugCoordinator(QObject *parent)
+    : QObject(parent)
+{
+    m_quietTimer.setSingleShot(true);
+    m_quietTimer.setInterval(QUIETINTERVAL);
+    connect(&m_quietTimer, &QTimer::timeout, this, &ScreenHotplugCoordinator::checkSettled);
+
+    m_maximumWaitTimer.setSingleShot(true);
+    m_maximumWaitTimer.setInterval(MAXIMUMWAIT);
+    connect(&m_maximumWaitTimer, &QTimer::timeout, this, &ScreenHotplugCoordinator::checkSettled);
+
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &ScreenHotplugCoordinator::trackScreen);
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &ScreenHotplugCoordinator::notifyChange);
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, &ScreenHotplugCoordinator::notifyChange);
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &ScreenHotplugCoordinator::notifyChange);
+
+    foreach (auto scr, qGuiApp->screens()) {
+        trackScreen(scr);
+    }
+}
+
+ScreenHotplugCoordinator::~ScreenHotplugCoordinator()
+{
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+bool ScreenHotplugCoordinator::isSettling() const
+{
+    return m_quietTimer.isActive() || m_maximumWaitTimer.isActive();
+}
+
+void ScreenHotplugCoordinator::trackScreen(QScreen *screen)
+{
+    if (screen) {
+        connect(screen, &QScreen::geometryChanged, this, &ScreenHotplugCoordinator::notifyChange, Qt::UniqueConnection);
+    }
+}
+
+QString ScreenHotplugCoordinator::screensState() const
+{
+    QString state = qGuiApp->primaryScreen() ? qGuiApp->primaryScreen()->name() : QString();
+
+    foreach (auto scr, qGuiApp->screens()) {
+        QRect geometry = scr->geometry();
+        state += QStringLiteral(";%1@%2,%3,%4x%5").arg(scr->name()).arg(geometry.x()).arg(geometry.y())
+                 .arg(geometry.width()).arg(geometry.height());
+    }
+
+    return state;
+}
+
+void ScreenHotplugCoordinator::notifyChange()
+{
+    m_stateOnLastChange = screensState();
+    m_quietTimer.start();
+
+    if (!m_maximumWaitTimer.isActive()) {
+        m_maximumWaitTimer.start();
+    }
+}
+
+void ScreenHotplugCoordinator::checkSettled()
+{
+    //! the screens may still be changing without any signal e.g. the RandR
+    //! state has not reached yet the QScreens, in such case keep waiting
+    QString state = screensState();
+
+    if (state != m_stateOnLastChange && m_maximumWaitTimer.isActive()) {
+        m_stateOnLastChange = state;
+        m_quietTimer.start();
+        return;
+    }
+
+    m_quietTimer.stop();
+    m_maximumWaitTimer.stop();
+
+    qDebug() << "screens settled :: " << state;
+
+    emit screensSettled();
+}
+
+}
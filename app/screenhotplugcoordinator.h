@@ -0,0 +1,72 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCREENHOTPLUGCOORDINATOR_H
+#define SCREENHOTPLUGCOORDINATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class QScreen;
+
+namespace Latte {
+
+//! A monitor replug produces a burst of RandR events and QScreen signals.
+//! This class collects all of them and emits screensSettled() only once,
+//! when the screens state has not changed for a quiet period. That way the
+//! docks are reassigned to screens in a single transaction instead of being
+//! removed and recreated for each intermediate state of the burst.
+class ScreenHotplugCoordinator : public QObject {
+    Q_OBJECT
+
+public:
+    ScreenHotplugCoordinator(QObject *parent = nullptr);
+    ~ScreenHotplugCoordinator() override;
+
+    //! a screens change has been reported and it is not settled yet
+    bool isSettling() const;
+
+public slots:
+    void notifyChange();
+
+signals:
+    void screensSettled();
+
+private slots:
+    void trackScreen(QScreen *screen);
+    void checkSettled();
+
+private:
+    //! connectors, geometries and primary screen of the running screens
+    QString screensState() const;
+
+private:
+    QString m_stateOnLastChange;
+
+    //! it is restarted on every change of the burst
+    QTimer m_quietTimer;
+    //! the burst can not postpone the docks reassignment forever
+    QTimer m_maximumWaitTimer;
+};
+
+}
+
+#endif // SCREENHOTPLUGCOORDINATOR_H
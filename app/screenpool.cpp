@@ -36,7 +36,21 @@ ScreenPool::ScreenPool(KSharedConfig::Ptr config, QObject *parent)
     : QObject(parent),
       m_configGroup(KConfigGroup(config, QStringLiteral("ScreenConnectors")))
 {
-    qApp->installNativeEventFilter(this);
+#if HAVE_X11
+
+    if (QX11Info::isPlatformX11()) {
+        const xcb_query_extension_reply_t *reply = xcb_get_extension_data(QX11Info::connection(), &xcb_randr_id);
+
+        if (reply && reply->present) {
+            m_randrEventBase = reply->first_event;
+        }
+    }
+
+#endif
+
+    if (m_randrEventBase >= 0) {
+        qApp->installNativeEventFilter(this);
+    }
 
     m_configSaveTimer.setSingleShot(true);
     connect(&m_configSaveTimer, &QTimer::timeout, this, [this]() {
@@ -247,33 +261,42 @@ bool ScreenPool::nativeEventFilter(const QByteArray &eventType, void *message, l
     // a particular edge case: when we switch the only enabled screen
     // we don't have any signal about it, the primary screen changes but we have the same old QScreen* getting recycled
     // see https://bugs.kde.org/show_bug.cgi?id=373880
-    // if this slot will be invoked many times, their//second time on will do nothing as name and primaryconnector will be the same by then
-    if (eventType != "xcb_generic_event_t") {
+    if (m_primaryReconciliationPending || eventType != "xcb_generic_event_t") {
         return false;
     }
 
-    xcb_generic_event_t *ev = static_cast<xcb_generic_event_t *>(message);
+    const auto responseType = XCB_EVENT_RESPONSE_TYPE(static_cast<xcb_generic_event_t *>(message));
 
-    const auto responseType = XCB_EVENT_RESPONSE_TYPE(ev);
+    if (responseType == m_randrEventBase + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
+        //! the event is processed by Qt after the filters, the queued call finds
+        //! the updated primary screen and a burst of events is coalesced
+        m_primaryReconciliationPending = true;
+        QMetaObject::invokeMethod(this, "reconcilePrimaryConnector", Qt::QueuedConnection);
+    }
 
-    const xcb_query_extension_reply_t *reply = xcb_get_extension_data(QX11Info::connection(), &xcb_randr_id);
+#endif
+    return false;
+}
 
-    if (responseType == reply->first_event + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
-        if (qGuiApp->primaryScreen()->name() != primaryConnector()) {
-            //new screen?
-            if (id(qGuiApp->primaryScreen()->name()) < 0) {
-                insertScreenMapping(firstAvailableId(), qGuiApp->primaryScreen()->name());
-            }
+void ScreenPool::reconcilePrimaryConnector()
+{
+    m_primaryReconciliationPending = false;
 
-            //switch the primary screen in the pool
-            setPrimaryConnector(qGuiApp->primaryScreen()->name());
+    QScreen *primary = qGuiApp->primaryScreen();
 
-            emit primaryPoolChanged();
-        }
+    if (!primary || primary->name() == primaryConnector()) {
+        return;
     }
 
-#endif
-    return false;
+    //new screen?
+    if (id(primary->name()) < 0) {
+        insertScreenMapping(firstAvailableId(), primary->name());
+    }
+
+    //switch the primary screen in the pool
+    setPrimaryConnector(primary->name());
+
+    emit primaryPoolChanged();
 }
 
 
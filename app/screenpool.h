@@ -63,9 +63,18 @@ signals:
 protected:
     bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) Q_DECL_OVERRIDE;
 
+private slots:
+    void reconcilePrimaryConnector();
+
 private:
     void save();
 
+    //! the filter runs for every xcb event of the application, it only
+    //! compares the event code and the reconciliation is deferred
+    bool m_primaryReconciliationPending{false};
+    //! the first event code of the RandR extension, -1 when it is not present
+    int m_randrEventBase{ -1};
+
     KConfigGroup m_configGroup;
     QString m_primaryConnector;
     //order is important
@@ -0,0 +1,96 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "screentopology.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+
+namespace Latte {
+
+bool ScreenTopology::Delta::isEmpty() const
+{
+    return !full && !primaryChanged && added.isEmpty() && removed.isEmpty() && replugged.isEmpty();
+}
+
+bool ScreenTopology::Delta::affects(const QString &connector) const
+{
+    return full || added.contains(connector) || removed.contains(connector) || replugged.contains(connector);
+}
+
+ScreenTopology::Delta ScreenTopology::Delta::fullDelta()
+{
+    Delta delta;
+    delta.full = true;
+
+    return delta;
+}
+
+ScreenTopology::Delta ScreenTopology::update()
+{
+    QHash<QString, QPointer<QScreen>> screens;
+
+    foreach (auto scr, qGuiApp->screens()) {
+        if (scr) {
+            screens[scr->name()] = scr;
+        }
+    }
+
+    QString primary = qGuiApp->primaryScreen() ? qGuiApp->primaryScreen()->name() : QString();
+
+    Delta delta;
+
+    for (auto it = screens.constBegin(); it != screens.constEnd(); ++it) {
+        if (!m_screens.contains(it.key())) {
+            delta.added.insert(it.key());
+        } else if (m_screens.value(it.key()) != it.value()) {
+            delta.replugged.insert(it.key());
+        }
+    }
+
+    for (auto it = m_screens.constBegin(); it != m_screens.constEnd(); ++it) {
+        if (!screens.contains(it.key())) {
+            delta.removed.insert(it.key());
+        }
+    }
+
+    delta.primaryChanged = (primary != m_primary);
+
+    m_screens = screens;
+    m_primary = primary;
+
+    qDebug() << "screen topology :: added :" << delta.added << " removed :" << delta.removed
+             << " replugged :" << delta.replugged << " primary changed :" << delta.primaryChanged;
+
+    return delta;
+}
+
+bool ScreenTopology::contains(const QString &connector) const
+{
+    return m_screens.contains(connector);
+}
+
+QString ScreenTopology::primary() const
+{
+    return m_primary;
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCREENTOPOLOGY_H
+#define SCREENTOPOLOGY_H
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+
+class QScreen;
+
+namespace Latte {
+
+//! This class keeps a snapshot of the running screens, identified by their
+//! connector names, and of the primary screen. Each update() returns the
+//! difference from the previous snapshot, so the docks are reconciled only
+//! for the screens that were actually added or removed.
+class ScreenTopology {
+public:
+    struct Delta {
+        QSet<QString> added;
+        QSet<QString> removed;
+        //! the connector is present in both snapshots but with a different
+        //! QScreen, e.g. it was unplugged and plugged again in a burst
+        QSet<QString> replugged;
+        bool primaryChanged{false};
+        //! every dock must be reconsidered e.g. for a layout leaving standby
+        bool full{false};
+
+        bool isEmpty() const;
+        bool affects(const QString &connector) const;
+
+        static Delta fullDelta();
+    };
+
+    Delta update();
+
+    bool contains(const QString &connector) const;
+    QString primary() const;
+
+private:
+    QHash<QString, QPointer<QScreen>> m_screens;
+    QString m_primary;
+};
+
+}
+
+#endif // SCREENTOPOLOGY_H
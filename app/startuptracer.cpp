@@ -0,0 +1,287 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "startuptracer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QQuickWindow>
+#include <QSharedPointer>
+#include <QThread>
+
+#include <algorithm>
+
+namespace Latte {
+
+class StartupTracerSingleton {
+public:
+    StartupTracerSingleton() {
+    }
+
+    StartupTracer self;
+};
+
+Q_GLOBAL_STATIC(StartupTracerSingleton, privateStartupTracerSelf)
+
+StartupTracer *StartupTracer::self()
+{
+    return &privateStartupTracerSelf->self;
+}
+
+StartupTracer::StartupTracer(QObject *parent)
+    : QObject(parent)
+{
+    m_windowTimer.setSingleShot(true);
+    connect(&m_windowTimer, &QTimer::timeout, this, &StartupTracer::finish);
+}
+
+StartupTracer::~StartupTracer()
+{
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+bool StartupTracer::isEnabled() const
+{
+    return m_enabled.loadAcquire();
+}
+
+void StartupTracer::start(const QString &file, int window)
+{
+    if (isEnabled() || m_finished || file.isEmpty()) {
+        return;
+    }
+
+    m_file = file;
+    m_clock.start();
+    m_enabled.storeRelease(1);
+
+    //! the window must outlast the startup timer of the visibility manager
+    m_windowTimer.setInterval(window);
+    m_windowTimer.start();
+}
+
+qint64 StartupTracer::elapsed() const
+{
+    return isEnabled() ? m_clock.nsecsElapsed() / 1000 : 0;
+}
+
+void StartupTracer::appendEvent(const Event &event)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    m_events.append(event);
+}
+
+void StartupTracer::addSpan(const QString &name, qint64 start, qint64 duration, const QVariantMap &args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    event.args = args;
+
+    appendEvent(event);
+}
+
+void StartupTracer::addMark(const QString &name, const QVariantMap &args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.isSpan = false;
+    event.start = elapsed();
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    event.args = args;
+
+    appendEvent(event);
+}
+
+void StartupTracer::traceFirstFrame(QQuickWindow *window, int containmentId)
+{
+    if (!isEnabled() || !window) {
+        return;
+    }
+
+    //! frameSwapped is emitted from the render thread, the mark is recorded
+    //! when the GUI thread receives it
+    auto connection = QSharedPointer<QMetaObject::Connection>::create();
+
+    *connection = connect(window, &QQuickWindow::frameSwapped, this, [this, connection, containmentId]() {
+        disconnect(*connection);
+
+        if (!isEnabled() || m_firstFrames.contains(containmentId)) {
+            return;
+        }
+
+        m_firstFrames[containmentId] = elapsed();
+        addMark(QStringLiteral("DockView::firstFrame"), {{QStringLiteral("containment"), containmentId}});
+    }, Qt::QueuedConnection);
+}
+
+void StartupTracer::markInteractive(int containmentId)
+{
+    if (!isEnabled() || m_interactive.contains(containmentId)) {
+        return;
+    }
+
+    m_interactive[containmentId] = elapsed();
+    addMark(QStringLiteral("VisibilityManager::interactive"), {{QStringLiteral("containment"), containmentId}});
+}
+
+QString StartupTracer::summary() const
+{
+    QString result;
+    QList<int> ids = m_firstFrames.keys();
+
+    foreach (auto id, m_interactive.keys()) {
+        if (!ids.contains(id)) {
+            ids.append(id);
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+
+    foreach (auto id, ids) {
+        QString firstFrame = m_firstFrames.contains(id) ? QString::number(m_firstFrames[id] / 1000.0, 'f', 1) + " ms" : QStringLiteral("-");
+        QString interactive = m_interactive.contains(id) ? QString::number(m_interactive[id] / 1000.0, 'f', 1) + " ms" : QStringLiteral("-");
+
+        result += QStringLiteral("  dock %1 :: first frame: %2, interactive: %3\n").arg(id).arg(firstFrame).arg(interactive);
+    }
+
+    return result;
+}
+
+void StartupTracer::finish()
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    m_windowTimer.stop();
+
+    QList<Event> events;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_enabled.storeRelease(0);
+        m_finished = true;
+        events = m_events;
+        m_events.clear();
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    foreach (auto event, events) {
+        QJsonObject object;
+        object[QStringLiteral("name")] = event.name;
+        object[QStringLiteral("cat")] = QStringLiteral("startup");
+        object[QStringLiteral("ph")] = event.isSpan ? QStringLiteral("X") : QStringLiteral("i");
+        object[QStringLiteral("ts")] = static_cast<double>(event.start);
+        object[QStringLiteral("pid")] = static_cast<double>(pid);
+        object[QStringLiteral("tid")] = static_cast<double>(event.threadId);
+
+        if (event.isSpan) {
+            object[QStringLiteral("dur")] = static_cast<double>(event.duration);
+        } else {
+            //! instant events are drawn through the whole process
+            object[QStringLiteral("s")] = QStringLiteral("p");
+        }
+
+        if (!event.args.isEmpty()) {
+            object[QStringLiteral("args")] = QJsonObject::fromVariantMap(event.args);
+        }
+
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root[QStringLiteral("traceEvents")] = traceEvents;
+    root[QStringLiteral("displayTimeUnit")] = QStringLiteral("ms");
+
+    //! the per dock measurements in milliseconds, for scripts comparing startups
+    QJsonObject docks;
+
+    foreach (auto id, m_firstFrames.keys() + m_interactive.keys()) {
+        QJsonObject dock;
+
+        if (m_firstFrames.contains(id)) {
+            dock[QStringLiteral("timeToFirstFrame")] = m_firstFrames[id] / 1000.0;
+        }
+
+        if (m_interactive.contains(id)) {
+            dock[QStringLiteral("timeToInteractive")] = m_interactive[id] / 1000.0;
+        }
+
+        docks[QString::number(id)] = dock;
+    }
+
+    root[QStringLiteral("otherData")] = QJsonObject{{QStringLiteral("docks"), docks}};
+
+    QFile file(m_file);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "StartupTracer :: trace cannot be written :: " << m_file;
+        return;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+
+    qInfo() << "Startup trace written in :" << m_file;
+    qInfo().noquote() << summary();
+}
+
+StartupSpan::StartupSpan(const QString &name, const QVariantMap &args)
+    : m_enabled(StartupTracer::self()->isEnabled())
+{
+    if (m_enabled) {
+        m_name = name;
+        m_args = args;
+        m_start = StartupTracer::self()->elapsed();
+    }
+}
+
+StartupSpan::~StartupSpan()
+{
+    if (m_enabled) {
+        auto tracer = StartupTracer::self();
+        tracer->addSpan(m_name, m_start, tracer->elapsed() - m_start, m_args);
+    }
+}
+
+}
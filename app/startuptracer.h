@@ -0,0 +1,119 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+
+class QQuickWindow;
+
+namespace Latte {
+
+//! This class records the critical path of Latte startup when the
+//! --trace-startup option is used. The recorded spans and marks are written
+//! as a Chrome trace-event file that can be opened from chrome://tracing
+//! and a short summary of time-to-first-frame and time-to-interactive for
+//! each dock is printed. When tracing is disabled every call returns early.
+class StartupTracer : public QObject {
+    Q_OBJECT
+
+public:
+    static StartupTracer *self();
+
+    StartupTracer(QObject *parent = nullptr);
+    ~StartupTracer() override;
+
+    bool isEnabled() const;
+
+    //! starts tracing, the trace is written in the given file when the
+    //! startup window expires or when finish() is called
+    void start(const QString &file, int window = 20000);
+    void finish();
+
+    //! microseconds since tracing started
+    qint64 elapsed() const;
+
+    void addSpan(const QString &name, qint64 start, qint64 duration, const QVariantMap &args = QVariantMap());
+    void addMark(const QString &name, const QVariantMap &args = QVariantMap());
+
+    //! the first frame of the window that was swapped after this call
+    void traceFirstFrame(QQuickWindow *window, int containmentId);
+    //! the dock applies its real visibility mode
+    void markInteractive(int containmentId);
+
+private:
+    struct Event {
+        QString name;
+        bool isSpan{true};
+        qint64 start{0};
+        qint64 duration{0};
+        qint64 threadId{0};
+        QVariantMap args;
+    };
+
+    void appendEvent(const Event &event);
+    QString summary() const;
+
+private:
+    //! it is read from the layouts loading threads, the clock is started
+    //! before tracing is enabled so it is valid whenever this is set
+    QAtomicInt m_enabled{0};
+    bool m_finished{false};
+
+    QString m_file;
+
+    QElapsedTimer m_clock;
+    QTimer m_windowTimer;
+
+    //! spans can be recorded from the layouts loading threads
+    mutable QMutex m_mutex;
+    QList<Event> m_events;
+
+    //! containment id -> microseconds since tracing started
+    QHash<int, qint64> m_firstFrames;
+    QHash<int, qint64> m_interactive;
+};
+
+//! records a span for the lifetime of the instance
+class StartupSpan {
+public:
+    StartupSpan(const QString &name, const QVariantMap &args = QVariantMap());
+    ~StartupSpan();
+
+private:
+    bool m_enabled{false};
+    qint64 m_start{0};
+
+    QString m_name;
+    QVariantMap m_args;
+};
+
+}
+
+#endif // STARTUPTRACER_H
@@ -20,6 +20,8 @@
 
 #include "universalsettings.h"
 
+#include "configsyncer.h"
+
 #include <QDir>
 
 namespace Latte {
@@ -33,7 +35,11 @@ UniversalSettings::UniversalSettings(KSharedConfig::Ptr config, QObject *parent)
     connect(this, &UniversalSettings::lastNonAssignedLayoutNameChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::launchersChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::layoutsMemoryUsageChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::lazyLayoutsChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::lazyLayoutsTimeoutChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::showInfoWindowChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::standbyLayoutsChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::standbyLayoutsMemoryBudgetChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::versionChanged, this, &UniversalSettings::saveConfig);
 }
 
@@ -41,6 +47,8 @@ UniversalSettings::~UniversalSettings()
 {
     saveConfig();
     cleanupSettings();
+
+    ConfigSyncer::self()->flush();
 }
 
 void UniversalSettings::load()
@@ -132,6 +140,72 @@ void UniversalSettings::setLayoutsWindowSize(QSize size)
     emit layoutsWindowSizeChanged();
 }
 
+int UniversalSettings::standbyLayouts() const
+{
+    return m_standbyLayouts;
+}
+
+void UniversalSettings::setStandbyLayouts(int count)
+{
+    count = qMax(0, count);
+
+    if (m_standbyLayouts == count) {
+        return;
+    }
+
+    m_standbyLayouts = count;
+    emit standbyLayoutsChanged();
+}
+
+int UniversalSettings::standbyLayoutsMemoryBudget() const
+{
+    return m_standbyLayoutsMemoryBudget;
+}
+
+void UniversalSettings::setStandbyLayoutsMemoryBudget(int budget)
+{
+    budget = qMax(0, budget);
+
+    if (m_standbyLayoutsMemoryBudget == budget) {
+        return;
+    }
+
+    m_standbyLayoutsMemoryBudget = budget;
+    emit standbyLayoutsMemoryBudgetChanged();
+}
+
+bool UniversalSettings::lazyLayouts() const
+{
+    return m_lazyLayouts;
+}
+
+void UniversalSettings::setLazyLayouts(bool lazy)
+{
+    if (m_lazyLayouts == lazy) {
+        return;
+    }
+
+    m_lazyLayouts = lazy;
+    emit lazyLayoutsChanged();
+}
+
+int UniversalSettings::lazyLayoutsTimeout() const
+{
+    return m_lazyLayoutsTimeout;
+}
+
+void UniversalSettings::setLazyLayoutsTimeout(int minutes)
+{
+    minutes = qMax(0, minutes);
+
+    if (m_lazyLayoutsTimeout == minutes) {
+        return;
+    }
+
+    m_lazyLayoutsTimeout = minutes;
+    emit lazyLayoutsTimeoutChanged();
+}
+
 QStringList UniversalSettings::launchers() const
 {
     return m_launchers;
@@ -172,7 +246,7 @@ void UniversalSettings::setAutostart(bool state)
         //! the first time that the user disables the autostart, this is recorded
         //! and from now own it will not be recreated it in the beginning
         if (!m_universalGroup.readEntry("userConfiguredAutostart", false)) {
-            m_universalGroup.writeEntry("userConfiguredAutostart", true);
+            ConfigSyncer::self()->writeEntry(m_universalGroup, QStringLiteral("userConfiguredAutostart"), true);
         }
 
         autostartFile.remove();
@@ -209,28 +283,34 @@ void UniversalSettings::loadConfig()
     m_layoutsWindowSize = m_universalGroup.readEntry("layoutsWindowSize", QSize(700, 450));
     m_launchers = m_universalGroup.readEntry("launchers", QStringList());
     m_showInfoWindow = m_universalGroup.readEntry("showInfoWindow", true);
+    m_standbyLayouts = qMax(0, m_universalGroup.readEntry("standbyLayouts", 2));
+    m_standbyLayoutsMemoryBudget = qMax(0, m_universalGroup.readEntry("standbyLayoutsMemoryBudget", 128));
+    m_lazyLayouts = m_universalGroup.readEntry("lazyLayouts", true);
+    m_lazyLayoutsTimeout = qMax(0, m_universalGroup.readEntry("lazyLayoutsTimeout", 0));
     m_memoryUsage = static_cast<Dock::LayoutsMemoryUsage>(m_universalGroup.readEntry("memoryUsage", (int)Dock::SingleLayout));
 }
 
 void UniversalSettings::saveConfig()
 {
-    m_universalGroup.writeEntry("version", m_version);
-    m_universalGroup.writeEntry("currentLayout", m_currentLayoutName);
-    m_universalGroup.writeEntry("lastNonAssignedLayout", m_lastNonAssignedLayoutName);
-    m_universalGroup.writeEntry("layoutsWindowSize", m_layoutsWindowSize);
-    m_universalGroup.writeEntry("launchers", m_launchers);
-    m_universalGroup.writeEntry("showInfoWindow", m_showInfoWindow);
-    m_universalGroup.writeEntry("memoryUsage", (int)m_memoryUsage);
-
-    m_universalGroup.sync();
+    ConfigSyncer *syncer = ConfigSyncer::self();
+
+    syncer->writeEntry(m_universalGroup, "version", m_version);
+    syncer->writeEntry(m_universalGroup, "currentLayout", m_currentLayoutName);
+    syncer->writeEntry(m_universalGroup, "lastNonAssignedLayout", m_lastNonAssignedLayoutName);
+    syncer->writeEntry(m_universalGroup, "layoutsWindowSize", m_layoutsWindowSize);
+    syncer->writeEntry(m_universalGroup, "launchers", m_launchers);
+    syncer->writeEntry(m_universalGroup, "showInfoWindow", m_showInfoWindow);
+    syncer->writeEntry(m_universalGroup, "standbyLayouts", m_standbyLayouts);
+    syncer->writeEntry(m_universalGroup, "standbyLayoutsMemoryBudget", m_standbyLayoutsMemoryBudget);
+    syncer->writeEntry(m_universalGroup, "lazyLayouts", m_lazyLayouts);
+    syncer->writeEntry(m_universalGroup, "lazyLayoutsTimeout", m_lazyLayoutsTimeout);
+    syncer->writeEntry(m_universalGroup, "memoryUsage", (int)m_memoryUsage);
 }
 
 void UniversalSettings::cleanupSettings()
 {
     KConfigGroup containments = KConfigGroup(m_config, QStringLiteral("Containments"));
-    containments.deleteGroup();
-
-    containments.sync();
+    ConfigSyncer::self()->deleteGroup(containments);
 }
 
 }
@@ -66,6 +66,25 @@ public:
     QSize layoutsWindowSize() const;
     void setLayoutsWindowSize(QSize);
 
+    //! the most recently used layouts that are kept loaded but hidden
+    //! in SingleLayout mode in order to switch to them instantly
+    int standbyLayouts() const;
+    void setStandbyLayouts(int count);
+
+    //! the memory budget in MB that the standby layouts can occupy
+    int standbyLayoutsMemoryBudget() const;
+    void setStandbyLayoutsMemoryBudget(int budget);
+
+    //! in MultipleLayouts the layouts of the background activities are kept
+    //! only as settings until one of their activities becomes current
+    bool lazyLayouts() const;
+    void setLazyLayouts(bool lazy);
+
+    //! minutes after which an idle background layout releases its docks again,
+    //! zero means that they are never released
+    int lazyLayoutsTimeout() const;
+    void setLazyLayoutsTimeout(int minutes);
+
     QStringList launchers() const;
     void setLaunchers(QStringList launcherList);
 
@@ -76,7 +95,11 @@ signals:
     void layoutsWindowSizeChanged();
     void launchersChanged();
     void layoutsMemoryUsageChanged();
+    void lazyLayoutsChanged();
+    void lazyLayoutsTimeoutChanged();
     void showInfoWindowChanged();
+    void standbyLayoutsChanged();
+    void standbyLayoutsMemoryBudgetChanged();
     void versionChanged();
 
 private slots:
@@ -90,11 +113,16 @@ private:
     void setLayoutsMemoryUsage(Dock::LayoutsMemoryUsage layoutsMemoryUsage);
 
 private:
+    bool m_lazyLayouts{true};
     bool m_showInfoWindow{true};
 
     //when there isnt a version it is an old universal file
     int m_version{1};
 
+    int m_standbyLayouts{2};
+    int m_standbyLayoutsMemoryBudget{128};
+    int m_lazyLayoutsTimeout{0};
+
     QString m_currentLayoutName;
     QString m_lastNonAssignedLayoutName;
     QSize m_layoutsWindowSize{700, 450};
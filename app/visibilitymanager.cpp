@@ -23,6 +23,7 @@
 #include "windowinfowrap.h"
 #include "dockview.h"
 #include "dockcorona.h"
+#include "startuptracer.h"
 #include "../liblattedock/extras.h"
 
 #include <QDebug>
@@ -195,6 +196,7 @@ inline void VisibilityManagerPrivate::setMode(Dock::Visibility mode)
     }
 
     view->containment()->config().writeEntry("visibility", static_cast<int>(mode));
+    view->containment()->configNeedsSaving();
 
     emit q->modeChanged();
 }
@@ -530,9 +532,11 @@ inline void VisibilityManagerPrivate::restoreConfig()
 
     if (mode() == Dock::AlwaysVisible) {
         setMode(Dock::AlwaysVisible);
+        StartupTracer::self()->markInteractive(view->containment()->id());
     } else {
         connect(&timerStartUp, &QTimer::timeout, this, [ &, mode]() {
             setMode(mode());
+            StartupTracer::self()->markInteractive(view->containment()->id());
         });
         connect(view->containment(), &Plasma::Containment::userConfiguringChanged
         , this, [&](bool configuring) {
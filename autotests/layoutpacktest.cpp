@@ -0,0 +1,253 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "configserializer.h"
+#include "layoutpack.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <KArchive/KArchiveDirectory>
+#include <KArchive/KArchiveFile>
+#include <KArchive/KTar>
+#include <KConfig>
+#include <KConfigGroup>
+
+using namespace Latte;
+
+class LayoutPackTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void presetRoundTrip_data();
+    void presetRoundTrip();
+    void configurationRoundTrip_data();
+    void configurationRoundTrip();
+    void configurationVersion2RoundTrip();
+
+    void keysStartingWithBracket();
+    void corruptedPackageWritesNothing();
+    void presentLayoutIsReused();
+
+private:
+    QString latteDirectory() const;
+    //! the Containments group of the layout file in its serialized form
+    QByteArray containmentsData(const QString &file) const;
+    QString copyPreset(const QString &name, const QString &directory) const;
+
+private:
+    QTemporaryDir m_home;
+};
+
+void LayoutPackTest::initTestCase()
+{
+    //! the latte directory of the imports is found in the home directory
+    QVERIFY(m_home.isValid());
+    qputenv("HOME", QFile::encodeName(m_home.path()));
+    QVERIFY(QDir(m_home.path()).mkpath(QStringLiteral(".config/latte")));
+}
+
+QString LayoutPackTest::latteDirectory() const
+{
+    return QDir::homePath() + "/.config/latte";
+}
+
+QByteArray LayoutPackTest::containmentsData(const QString &file) const
+{
+    KConfig config(file, KConfig::SimpleConfig);
+
+    return ConfigSerializer::groupData(KConfigGroup(&config, "Containments"));
+}
+
+QString LayoutPackTest::copyPreset(const QString &name, const QString &directory) const
+{
+    QString file = directory + "/" + name + ".layout.latte";
+    QFile::remove(file);
+    QFile::copy(QStringLiteral(LATTE_PACKAGE_DIR) + "/presets/" + name + ".layout.latte", file);
+    QFile(file).setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+
+    return file;
+}
+
+void LayoutPackTest::presetRoundTrip_data()
+{
+    QTest::addColumn<QString>("file");
+
+    QDir presets(QStringLiteral(LATTE_PACKAGE_DIR) + "/presets");
+
+    foreach (auto file, presets.entryList({QStringLiteral("*.layout.latte")}, QDir::Files)) {
+        QTest::newRow(qPrintable(file)) << presets.absoluteFilePath(file);
+    }
+}
+
+void LayoutPackTest::presetRoundTrip()
+{
+    QFETCH(QString, file);
+
+    QCOMPARE(LayoutPack::roundTripIssues(file), QStringList());
+}
+
+void LayoutPackTest::configurationRoundTrip_data()
+{
+    QTest::addColumn<QString>("file");
+
+    QDir layouts(QStringLiteral(LATTE_PACKAGE_DIR) + "/layouts");
+
+    foreach (auto file, layouts.entryList({QStringLiteral("*.latterc")}, QDir::Files)) {
+        QTest::newRow(qPrintable(file)) << layouts.absoluteFilePath(file);
+    }
+}
+
+void LayoutPackTest::configurationRoundTrip()
+{
+    QFETCH(QString, file);
+
+    QCOMPARE(LayoutPack::roundTripIssues(file), QStringList());
+}
+
+void LayoutPackTest::configurationVersion2RoundTrip()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString configFile = tempDir.path() + "/Full.latterc";
+
+    {
+        KTar archive(configFile, QStringLiteral("application/x-tar"));
+        QVERIFY(archive.open(QIODevice::WriteOnly));
+        QVERIFY(archive.writeFile(QStringLiteral("lattedockrc"), QByteArray("[UniversalSettings]\nversion=2\n")));
+
+        foreach (auto name, QStringList({QStringLiteral("Default"), QStringLiteral("Unity")})) {
+            QFile preset(QStringLiteral(LATTE_PACKAGE_DIR) + "/presets/" + name + ".layout.latte");
+            QVERIFY(preset.open(QIODevice::ReadOnly));
+            QVERIFY(archive.writeFile("latte/" + name + ".layout.latte", preset.readAll()));
+        }
+
+        archive.close();
+    }
+
+    QCOMPARE(LayoutPack::roundTripIssues(configFile), QStringList());
+}
+
+void LayoutPackTest::keysStartingWithBracket()
+{
+    KConfig source(QString(), KConfig::SimpleConfig);
+    KConfigGroup sourceGroup(&source, "Containments");
+    KConfigGroup general = sourceGroup.group("1").group("General");
+    general.writeEntry("[bracket", "value");
+    general.writeEntry("key[1]", "[value]");
+    general.writeEntry("multi\nline", "multi\nline");
+
+    KConfig target(QString(), KConfig::SimpleConfig);
+    KConfigGroup targetGroup(&target, "Containments");
+    ConfigSerializer::readGroupData(ConfigSerializer::groupData(sourceGroup), targetGroup);
+
+    QCOMPARE(targetGroup.groupList(), QStringList(QStringLiteral("1")));
+    QCOMPARE(targetGroup.group("1").groupList(), QStringList(QStringLiteral("General")));
+    QCOMPARE(targetGroup.group("1").group("General").entryMap(), general.entryMap());
+}
+
+void LayoutPackTest::corruptedPackageWritesNothing()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString packFile = tempDir.path() + "/layouts.lattepack";
+    QString corruptedFile = tempDir.path() + "/corrupted.lattepack";
+
+    QVERIFY(LayoutPack::exportLayouts({copyPreset(QStringLiteral("Default"), tempDir.path()),
+                                       copyPreset(QStringLiteral("Plasma"), tempDir.path())}, packFile));
+
+    //! one blob of the package is changed, the other ones are still valid
+    {
+        KTar pack(packFile, QStringLiteral("application/x-gzip"));
+        KTar corrupted(corruptedFile, QStringLiteral("application/x-gzip"));
+        QVERIFY(pack.open(QIODevice::ReadOnly));
+        QVERIFY(corrupted.open(QIODevice::WriteOnly));
+
+        const KArchiveDirectory *blobs = static_cast<const KArchiveDirectory *>(pack.directory()->entry(QStringLiteral("blobs")));
+        QStringList hashes = blobs->entries();
+        hashes.sort();
+
+        foreach (auto hash, hashes) {
+            QByteArray data = blobs->file(hash)->data();
+            QVERIFY(corrupted.writeFile("blobs/" + hash, hash == hashes.last() ? data + "corrupted" : data));
+        }
+
+        QVERIFY(corrupted.writeFile(QStringLiteral("manifest.json"), pack.directory()->file(QStringLiteral("manifest.json"))->data()));
+        corrupted.close();
+    }
+
+    QDir extractDir(tempDir.path() + "/extracted");
+    QVERIFY(extractDir.mkpath(QStringLiteral(".")));
+
+    QCOMPARE(LayoutPack::extractLayouts(corruptedFile, extractDir.path()), QStringList());
+    QCOMPARE(extractDir.entryList(QDir::Files), QStringList());
+
+    QCOMPARE(LayoutPack::extractLayouts(packFile, extractDir.path()).count(), 2);
+}
+
+void LayoutPackTest::presentLayoutIsReused()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString presentFile = copyPreset(QStringLiteral("Default"), latteDirectory());
+    QString changedFile = copyPreset(QStringLiteral("Default"), tempDir.path());
+    QString packFile = tempDir.path() + "/layouts.lattepack";
+
+    //! an identical layout is not imported again
+    QVERIFY(LayoutPack::exportLayouts({changedFile}, packFile));
+    QCOMPARE(LayoutPack::extractLayouts(packFile, latteDirectory()), QStringList());
+
+    //! a changed applet, a new containment and a removed applet
+    {
+        KConfig changed(changedFile, KConfig::SimpleConfig);
+        KConfigGroup containments(&changed, "Containments");
+        QString cId = containments.groupList().first();
+        KConfigGroup applets = containments.group(cId).group("Applets");
+        QStringList appletsIds = applets.groupList();
+        QVERIFY(appletsIds.count() >= 2);
+
+        applets.group(appletsIds.first()).group("Configuration").writeEntry("changedByTest", true);
+        applets.group(appletsIds.last()).deleteGroup();
+        containments.group("999").writeEntry("plugin", "org.kde.latte.containment");
+        changed.sync();
+    }
+
+    QFile::remove(packFile);
+    QVERIFY(LayoutPack::exportLayouts({changedFile}, packFile));
+
+    QStringList files = LayoutPack::extractLayouts(packFile, latteDirectory());
+    QCOMPARE(files.count(), 1);
+    QVERIFY(files.first() != presentFile);
+    QCOMPARE(containmentsData(files.first()), containmentsData(changedFile));
+
+    QFile::remove(files.first());
+    QFile::remove(presentFile);
+}
+
+QTEST_GUILESS_MAIN(LayoutPackTest)
+
+#include "layoutpacktest.moc"
@@ -0,0 +1,101 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "screenpool.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+#include <QVector>
+
+#include <KSharedConfig>
+
+#include <xcb/xcb.h>
+
+//! the filter is protected, it is called from Qt for every native event
+class BenchmarkScreenPool : public ScreenPool {
+public:
+    BenchmarkScreenPool(KSharedConfig::Ptr config)
+        : ScreenPool(config)
+    {
+    }
+
+    using ScreenPool::nativeEventFilter;
+};
+
+class ScreenPoolBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void nativeEventFilter_data();
+    void nativeEventFilter();
+
+private:
+    QTemporaryDir m_configDir;
+};
+
+void ScreenPoolBenchmark::initTestCase()
+{
+    QVERIFY(m_configDir.isValid());
+}
+
+void ScreenPoolBenchmark::nativeEventFilter_data()
+{
+    QTest::addColumn<QByteArray>("eventType");
+    QTest::addColumn<int>("responseType");
+
+    QTest::newRow("motion notify") << QByteArrayLiteral("xcb_generic_event_t") << int(XCB_MOTION_NOTIFY);
+    QTest::newRow("property notify") << QByteArrayLiteral("xcb_generic_event_t") << int(XCB_PROPERTY_NOTIFY);
+    QTest::newRow("other event type") << QByteArrayLiteral("windows_generic_MSG") << 0;
+}
+
+void ScreenPoolBenchmark::nativeEventFilter()
+{
+    QFETCH(QByteArray, eventType);
+    QFETCH(int, responseType);
+
+    BenchmarkScreenPool pool(KSharedConfig::openConfig(m_configDir.path() + "/lattedockrc"));
+
+    //! a burst of synthetic events, the filter never consumes them
+    const int events = 1000;
+    QVector<xcb_generic_event_t> burst(events);
+
+    for (int i = 0; i < events; ++i) {
+        burst[i] = xcb_generic_event_t();
+        burst[i].response_type = static_cast<uint8_t>(responseType);
+        burst[i].sequence = static_cast<uint16_t>(i);
+    }
+
+    long result{0};
+    bool filtered{false};
+
+    QBENCHMARK {
+        for (int i = 0; i < events; ++i) {
+            filtered = pool.nativeEventFilter(eventType, &burst[i], &result) || filtered;
+        }
+    }
+
+    QVERIFY(!filtered);
+}
+
+QTEST_GUILESS_MAIN(ScreenPoolBenchmark)
+
+#include "screenpoolbenchmark.moc"
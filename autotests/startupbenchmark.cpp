@@ -0,0 +1,124 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTest>
+
+//! Cold-starts latte-dock with a fixture layout under the offscreen platform
+//! and reports the time-to-first-frame and time-to-interactive of each dock,
+//! as they are written from --trace-startup. The layouts are loaded only when
+//! the activities service is running, so it is run from a session through
+//! the startup-benchmark target and it is not part of the autotests.
+class StartupBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void coldStart_data();
+    void coldStart();
+};
+
+void StartupBenchmark::coldStart_data()
+{
+    QTest::addColumn<QString>("layout");
+
+    QTest::newRow("Default") << QStringLiteral("Default");
+    QTest::newRow("Extended") << QStringLiteral("Extended");
+    QTest::newRow("Plasma") << QStringLiteral("Plasma");
+    QTest::newRow("Unity") << QStringLiteral("Unity");
+}
+
+void StartupBenchmark::coldStart()
+{
+    QFETCH(QString, layout);
+
+    QTemporaryDir home;
+    QVERIFY(home.isValid());
+
+    //! a clean home, so the fixture layout and a cold configuration are used
+    QDir latteDir(home.path() + "/.config/latte");
+    QVERIFY(latteDir.mkpath(QStringLiteral(".")));
+    QVERIFY(QFile::copy(QStringLiteral(LATTE_PACKAGE_DIR) + "/presets/" + layout + ".layout.latte",
+                        latteDir.absoluteFilePath(layout + ".layout.latte")));
+
+    QString traceFile = home.path() + "/startup.json";
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("HOME"), home.path());
+    environment.insert(QStringLiteral("XDG_CONFIG_HOME"), home.path() + "/.config");
+    environment.insert(QStringLiteral("XDG_CACHE_HOME"), home.path() + "/.cache");
+    //! the instance lock file is created in the temporary directory
+    environment.insert(QStringLiteral("TMPDIR"), home.path());
+    environment.insert(QStringLiteral("QT_QPA_PLATFORM"), QStringLiteral("offscreen"));
+
+    QProcess latte;
+    latte.setProcessEnvironment(environment);
+    latte.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    latte.start(QStringLiteral(LATTE_DOCK_EXECUTABLE), {QStringLiteral("--layout"), layout,
+                                                         QStringLiteral("--trace-startup"), traceFile});
+    QVERIFY(latte.waitForStarted());
+
+    //! the trace is written when the startup window of the tracer expires
+    QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(traceFile) && QFileInfo(traceFile).size() > 0, 60000);
+
+    latte.terminate();
+
+    if (!latte.waitForFinished(10000)) {
+        latte.kill();
+        latte.waitForFinished();
+    }
+
+    QFile trace(traceFile);
+    QVERIFY(trace.open(QIODevice::ReadOnly));
+
+    QJsonObject docks = QJsonDocument::fromJson(trace.readAll()).object()
+                        .value(QStringLiteral("otherData")).toObject()
+                        .value(QStringLiteral("docks")).toObject();
+
+    QVERIFY2(!docks.isEmpty(), "no docks were loaded, is the activities service running and no other Latte instance?");
+
+    double firstFrame{0};
+
+    for (auto it = docks.constBegin(); it != docks.constEnd(); ++it) {
+        QJsonObject dock = it.value().toObject();
+
+        QVERIFY2(dock.contains(QStringLiteral("timeToFirstFrame")), qPrintable("dock " + it.key() + " has no first frame"));
+        QVERIFY2(dock.contains(QStringLiteral("timeToInteractive")), qPrintable("dock " + it.key() + " is not interactive"));
+
+        qInfo().noquote() << QStringLiteral("%1 :: dock %2 :: first frame: %3 ms, interactive: %4 ms")
+                          .arg(layout).arg(it.key())
+                          .arg(dock.value(QStringLiteral("timeToFirstFrame")).toDouble(), 0, 'f', 1)
+                          .arg(dock.value(QStringLiteral("timeToInteractive")).toDouble(), 0, 'f', 1);
+
+        firstFrame = qMax(firstFrame, dock.value(QStringLiteral("timeToFirstFrame")).toDouble());
+    }
+
+    //! the slowest dock defines when the layout is shown
+    QTest::setBenchmarkResult(firstFrame, QTest::WalltimeMilliseconds);
+}
+
+QTEST_GUILESS_MAIN(StartupBenchmark)
+
+#include "startupbenchmark.moc"
@@ -33,6 +33,19 @@ Window{
 
     property string space:" :   "
 
+    property var memory: dock ? dock.memoryReport() : ({})
+
+    Timer {
+        interval: 2000
+        repeat: true
+        running: true
+        onTriggered: memory = dock ? dock.memoryReport() : ({});
+    }
+
+    function megabytes(bytes) {
+        return bytes !== undefined ? (bytes / (1024*1024)).toFixed(2) + " MB" : "___";
+    }
+
     PlasmaExtras.ScrollArea {
         id: scrollArea
 
@@ -736,6 +749,59 @@ Window{
                 text: layoutsContainer.endLayout.sizeWithNoFillApplets+" px."
             }
 
+            Text{
+                text: "   -----------   "
+            }
+
+            Text{
+                text: " -----------   "
+            }
+
+            Text{
+                text: "Objects / Items"+space
+            }
+
+            Text{
+                text: memory.objects !== undefined ? memory.objects + " / " + memory.items : "___"
+            }
+
+            Text{
+                text: "Icons and Images (estimated)"+space
+            }
+
+            Text{
+                text: memory.imageItems !== undefined ? memory.imageItems + " : " + megabytes(memory.imageBytes) : "___"
+            }
+
+            Text{
+                text: "Window Buffer (estimated)"+space
+            }
+
+            Text{
+                text: megabytes(memory.windowBytes)
+            }
+
+            Text{
+                text: "Applets Objects / Items"+space
+            }
+
+            Text{
+                text: {
+                    if (!memory.applets) {
+                        return "___";
+                    }
+
+                    var lines = [];
+
+                    for (var i=0; i<memory.applets.length; ++i) {
+                        var applet = memory.applets[i];
+                        lines.push(applet.plugin + " (" + applet.id + ") : " + applet.objects + " / " + applet.items + " , " + megabytes(applet.imageBytes));
+                    }
+
+                    return lines.join("\n");
+                }
+            }
+
         }
 
     }
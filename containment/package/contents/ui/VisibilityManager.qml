@@ -170,6 +170,18 @@ Item{
         }
     }
 
+    //! a standby layout that becomes active again must slide in its docks
+    Connections{
+        target: root.dockManagedLayout ? root.dockManagedLayout : null
+        onStandbyChanged: {
+            if (!root.dockManagedLayout.standby) {
+                manager.inTempHiding = false;
+                manager.inForceHiding = false;
+                delayAnimationTimer.start();
+            }
+        }
+    }
+
     onInStartupChanged: {
         if (!inStartup) {
             delayAnimationTimer.start();
@@ -1064,7 +1064,7 @@ DragDrop.DropArea {
     }
 
     function setGlobalDirectRender(value) {
-        if (latteApplet && latteApplet.waitingLaunchers.length > 0)
+        if (latteApplet && latteApplet.tasksProxyModel.waitingLaunchersCount > 0)
             return;
 
         root.globalDirectRender = value;
@@ -1530,7 +1530,7 @@ DragDrop.DropArea {
         id: enableDirectRenderTimer
         interval: 4 * root.durationTime * units.shortDuration
         onTriggered: {
-            if (latteApplet && latteApplet.waitingLaunchers.length > 0)
+            if (latteApplet && latteApplet.tasksProxyModel.waitingLaunchersCount > 0)
                 return;
 
             if (dock.visibility.containsMouse)
@@ -22,6 +22,7 @@
 #include "quickwindowsystem.h"
 #include "dock.h"
 #include "iconitem.h"
+#include "tasksproxymodel.h"
 
 #include <QtQml>
 
@@ -30,5 +31,6 @@ void LatteDockPlugin::registerTypes(const char *uri)
     Q_ASSERT(uri == QLatin1String("org.kde.latte"));
     qmlRegisterUncreatableType<Latte::Dock>(uri, 0, 1, "Dock", "Latte Dock Types uncreatable");
     qmlRegisterType<Latte::IconItem>(uri, 0, 1, "IconItem");
+    qmlRegisterType<Latte::TasksProxyModel>(uri, 0, 1, "TasksProxyModel");
     qmlRegisterSingletonType<Latte::QuickWindowSystem>(uri, 0, 1, "WindowSystem", &Latte::windowsystem_qobject_singletontype_provider);
 }
@@ -0,0 +1,425 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tasksproxymodel.h"
+
+#include <QDebug>
+
+namespace Latte {
+
+TasksProxyModel::TasksProxyModel(QObject *parent)
+    : QIdentityProxyModel(parent)
+{
+}
+
+TasksProxyModel::~TasksProxyModel()
+{
+    qDebug() << staticMetaObject.className() << "destructed";
+}
+
+void TasksProxyModel::setTasksModel(QAbstractItemModel *model)
+{
+    if (sourceModel() == model) {
+        return;
+    }
+
+    setSourceModel(model);
+
+    emit tasksModelChanged();
+}
+
+void TasksProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    if (sourceModel()) {
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    }
+
+    QIdentityProxyModel::setSourceModel(model);
+
+    if (model) {
+        connect(model, &QAbstractItemModel::dataChanged, this, &TasksProxyModel::onSourceDataChanged);
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TasksProxyModel::onSourceRowsAboutToBeRemoved);
+        connect(model, &QAbstractItemModel::rowsInserted, this, &TasksProxyModel::onSourceRowsInserted);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &TasksProxyModel::onSourceRowsRemoved);
+        connect(model, &QAbstractItemModel::rowsMoved, this, &TasksProxyModel::onSourceRowsMoved);
+        connect(model, &QAbstractItemModel::modelReset, this, &TasksProxyModel::rebuildIndexes);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &TasksProxyModel::rebuildIndexes);
+    }
+
+    rebuildIndexes();
+}
+
+QStringList TasksProxyModel::launcherList() const
+{
+    return m_launcherList;
+}
+
+void TasksProxyModel::setLauncherList(const QStringList &launchers)
+{
+    if (m_launcherList == launchers) {
+        return;
+    }
+
+    m_launcherList = launchers;
+    m_launchers = QSet<QString>::fromList(launchers);
+
+    emit launcherListChanged();
+}
+
+int TasksProxyModel::separatorsCount() const
+{
+    return m_separatorsCount;
+}
+
+int TasksProxyModel::firstRealTaskIndex() const
+{
+    return m_firstRealTaskIndex;
+}
+
+int TasksProxyModel::lastRealTaskIndex() const
+{
+    return m_lastRealTaskIndex;
+}
+
+int TasksProxyModel::waitingLaunchersCount() const
+{
+    return m_waitingLaunchers.count();
+}
+
+bool TasksProxyModel::launcherExists(const QString &url) const
+{
+    return m_launchers.contains(url);
+}
+
+bool TasksProxyModel::taskExists(const QString &url) const
+{
+    return m_tasksPerLauncher.value(url, 0) > 0;
+}
+
+bool TasksProxyModel::appIdExists(const QString &appId) const
+{
+    return m_rowsPerAppId.value(appId, 0) > 0;
+}
+
+bool TasksProxyModel::isSeparator(int row) const
+{
+    if (row < 0 || row >= m_rows.count()) {
+        return false;
+    }
+
+    return m_rows.at(row).isSeparator;
+}
+
+bool TasksProxyModel::isSeparatorUrl(const QString &url) const
+{
+    return url.contains(QLatin1String("latte-separator")) && url.endsWith(QLatin1String(".desktop"));
+}
+
+QStringList TasksProxyModel::separators() const
+{
+    QStringList result;
+
+    if (m_separatorsCount == 0) {
+        return result;
+    }
+
+    for (const auto &entry : m_rows) {
+        if (entry.isSeparator) {
+            result << entry.launcherUrl;
+        }
+    }
+
+    return result;
+}
+
+QVariantList TasksProxyModel::separatorsIndexes() const
+{
+    QVariantList result;
+
+    if (m_separatorsCount == 0) {
+        return result;
+    }
+
+    for (int i = 0; i < m_rows.count(); ++i) {
+        if (m_rows.at(i).isSeparator) {
+            result << i;
+        }
+    }
+
+    return result;
+}
+
+QString TasksProxyModel::lastSeparator() const
+{
+    if (m_separatorsCount == 0) {
+        return QString();
+    }
+
+    for (int i = m_rows.count() - 1; i >= 0; --i) {
+        if (m_rows.at(i).isSeparator) {
+            return m_rows.at(i).launcherUrl;
+        }
+    }
+
+    return QString();
+}
+
+void TasksProxyModel::addWaitingLauncher(const QString &launcher)
+{
+    if (m_waitingLaunchers.contains(launcher)) {
+        return;
+    }
+
+    m_waitingLaunchers.insert(launcher);
+
+    emit waitingLaunchersChanged();
+}
+
+void TasksProxyModel::removeWaitingLauncher(const QString &launcher)
+{
+    if (!m_waitingLaunchers.remove(launcher)) {
+        return;
+    }
+
+    emit waitingLaunchersChanged();
+    emit waitingLauncherRemoved(launcher);
+}
+
+bool TasksProxyModel::waitingLauncherExists(const QString &launcher) const
+{
+    return m_waitingLaunchers.contains(launcher);
+}
+
+TasksProxyModel::TaskEntry TasksProxyModel::entryForRow(int row) const
+{
+    TaskEntry entry;
+    QAbstractItemModel *model = sourceModel();
+
+    if (!model) {
+        return entry;
+    }
+
+    const QModelIndex index = model->index(row, 0);
+
+    if (m_launcherUrlRole >= 0) {
+        entry.launcherUrl = model->data(index, m_launcherUrlRole).toUrl().toString();
+    }
+
+    if (m_appIdRole >= 0) {
+        entry.appId = model->data(index, m_appIdRole).toString();
+    }
+
+    entry.isWindow = m_isWindowRole >= 0 && model->data(index, m_isWindowRole).toBool();
+    entry.isSeparator = isSeparatorUrl(entry.launcherUrl);
+
+    return entry;
+}
+
+void TasksProxyModel::addToIndexes(const TaskEntry &entry)
+{
+    if (entry.isWindow && !entry.launcherUrl.isEmpty()) {
+        ++m_tasksPerLauncher[entry.launcherUrl];
+    }
+
+    if (!entry.appId.isEmpty()) {
+        ++m_rowsPerAppId[entry.appId];
+    }
+
+    if (entry.isSeparator) {
+        ++m_separatorsCount;
+    }
+}
+
+void TasksProxyModel::removeFromIndexes(const TaskEntry &entry)
+{
+    if (entry.isWindow && !entry.launcherUrl.isEmpty()) {
+        auto it = m_tasksPerLauncher.find(entry.launcherUrl);
+
+        if (it != m_tasksPerLauncher.end() && --it.value() <= 0) {
+            m_tasksPerLauncher.erase(it);
+        }
+    }
+
+    if (!entry.appId.isEmpty()) {
+        auto it = m_rowsPerAppId.find(entry.appId);
+
+        if (it != m_rowsPerAppId.end() && --it.value() <= 0) {
+            m_rowsPerAppId.erase(it);
+        }
+    }
+
+    if (entry.isSeparator) {
+        --m_separatorsCount;
+    }
+}
+
+void TasksProxyModel::updateRealTaskIndexes(bool forceSignal)
+{
+    int first = m_rows.isEmpty() ? -1 : 0;
+    int last = m_rows.count() - 1;
+
+    //! only the consequent separators at the edges are visited
+    if (m_separatorsCount > 0) {
+        while (first >= 0 && first < m_rows.count() && m_rows.at(first).isSeparator) {
+            ++first;
+        }
+
+        while (last >= 0 && m_rows.at(last).isSeparator) {
+            --last;
+        }
+
+        //! only separators are present
+        if (first >= m_rows.count() || last < 0) {
+            first = 0;
+            last = m_rows.count() - 1;
+        }
+    }
+
+    if (first != m_firstRealTaskIndex || last != m_lastRealTaskIndex || forceSignal) {
+        m_firstRealTaskIndex = first;
+        m_lastRealTaskIndex = last;
+
+        emit separatorsChanged();
+    }
+}
+
+void TasksProxyModel::rebuildIndexes()
+{
+    m_rows.clear();
+    m_tasksPerLauncher.clear();
+    m_rowsPerAppId.clear();
+    m_separatorsCount = 0;
+
+    m_launcherUrlRole = -1;
+    m_appIdRole = -1;
+    m_isWindowRole = -1;
+
+    QAbstractItemModel *model = sourceModel();
+
+    if (model) {
+        const QHash<int, QByteArray> roles = model->roleNames();
+
+        for (auto it = roles.constBegin(); it != roles.constEnd(); ++it) {
+            if (it.value() == "LauncherUrlWithoutIcon") {
+                m_launcherUrlRole = it.key();
+            } else if (it.value() == "AppId") {
+                m_appIdRole = it.key();
+            } else if (it.value() == "IsWindow") {
+                m_isWindowRole = it.key();
+            }
+        }
+
+        const int count = model->rowCount();
+        m_rows.reserve(count);
+
+        for (int i = 0; i < count; ++i) {
+            m_rows.append(entryForRow(i));
+            addToIndexes(m_rows.last());
+        }
+    }
+
+    updateRealTaskIndexes(true);
+}
+
+void TasksProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+
+    const int separators = m_separatorsCount;
+
+    for (int i = topLeft.row(); i <= bottomRight.row() && i < m_rows.count(); ++i) {
+        removeFromIndexes(m_rows.at(i));
+        m_rows[i] = entryForRow(i);
+        addToIndexes(m_rows.at(i));
+    }
+
+    updateRealTaskIndexes(separators != m_separatorsCount);
+}
+
+void TasksProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    for (int i = first; i <= last && i < m_rows.count(); ++i) {
+        removeFromIndexes(m_rows.at(i));
+    }
+}
+
+void TasksProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const int separators = m_separatorsCount;
+
+    m_rows.insert(first, last - first + 1, TaskEntry());
+
+    for (int i = first; i <= last; ++i) {
+        m_rows[i] = entryForRow(i);
+        addToIndexes(m_rows.at(i));
+    }
+
+    //! separators after the insertion point changed their index
+    updateRealTaskIndexes(m_separatorsCount > 0 || separators != m_separatorsCount);
+}
+
+void TasksProxyModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const bool hadSeparators = m_separatorsCount > 0;
+
+    if (first < m_rows.count()) {
+        m_rows.remove(first, qMin(last, m_rows.count() - 1) - first + 1);
+    }
+
+    updateRealTaskIndexes(hadSeparators);
+}
+
+void TasksProxyModel::onSourceRowsMoved(const QModelIndex &parent, int start, int end, const QModelIndex &destination, int row)
+{
+    if (parent.isValid() || destination.isValid()) {
+        rebuildIndexes();
+        return;
+    }
+
+    const int count = end - start + 1;
+    const QVector<TaskEntry> moved = m_rows.mid(start, count);
+
+    m_rows.remove(start, count);
+
+    //! destination row is given before the removal of the moved rows
+    const int to = (row > start) ? row - count : row;
+
+    for (int i = 0; i < moved.count(); ++i) {
+        m_rows.insert(to + i, moved.at(i));
+    }
+
+    updateRealTaskIndexes(m_separatorsCount > 0);
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKSPROXYMODEL_H
+#define TASKSPROXYMODEL_H
+
+#include <QHash>
+#include <QIdentityProxyModel>
+#include <QSet>
+#include <QStringList>
+#include <QVariantList>
+#include <QVector>
+
+namespace Latte {
+
+/**
+ * @brief The TasksProxyModel class,
+ * is an identity proxy over the TaskManager.TasksModel of the Latte plasmoid
+ * that keeps hash indexes for launcher urls, app ids and internal separators.
+ * It is used from the plasmoid in order to avoid linear scans over the
+ * tasks and the launchers list in hover and drag code paths.
+ */
+class TasksProxyModel : public QIdentityProxyModel {
+    Q_OBJECT
+
+    Q_PROPERTY(QAbstractItemModel *tasksModel READ sourceModel WRITE setTasksModel NOTIFY tasksModelChanged)
+
+    /**
+     * The launchers list of the tasks model, it is indexed for launcherExists()
+     */
+    Q_PROPERTY(QStringList launcherList READ launcherList WRITE setLauncherList NOTIFY launcherListChanged)
+
+    Q_PROPERTY(int separatorsCount READ separatorsCount NOTIFY separatorsChanged)
+
+    /**
+     * First and last task indexes found after the consequent internal separators
+     * at the start and at the end of the tasks
+     */
+    Q_PROPERTY(int firstRealTaskIndex READ firstRealTaskIndex NOTIFY separatorsChanged)
+    Q_PROPERTY(int lastRealTaskIndex READ lastRealTaskIndex NOTIFY separatorsChanged)
+
+    Q_PROPERTY(int waitingLaunchersCount READ waitingLaunchersCount NOTIFY waitingLaunchersChanged)
+
+public:
+    explicit TasksProxyModel(QObject *parent = nullptr);
+    virtual ~TasksProxyModel();
+
+    void setTasksModel(QAbstractItemModel *model);
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QStringList launcherList() const;
+    void setLauncherList(const QStringList &launchers);
+
+    int separatorsCount() const;
+    int firstRealTaskIndex() const;
+    int lastRealTaskIndex() const;
+
+    int waitingLaunchersCount() const;
+
+    Q_INVOKABLE bool launcherExists(const QString &url) const;
+    //! a window is present for that launcher url, startups are not counted
+    Q_INVOKABLE bool taskExists(const QString &url) const;
+    Q_INVOKABLE bool appIdExists(const QString &appId) const;
+
+    Q_INVOKABLE bool isSeparator(int row) const;
+    Q_INVOKABLE bool isSeparatorUrl(const QString &url) const;
+    //! ordered by their task index
+    Q_INVOKABLE QStringList separators() const;
+    Q_INVOKABLE QVariantList separatorsIndexes() const;
+    Q_INVOKABLE QString lastSeparator() const;
+
+    //! waiting launchers are used in order to check
+    //! a window or startup if its launcher is playing its animation
+    Q_INVOKABLE void addWaitingLauncher(const QString &launcher);
+    Q_INVOKABLE void removeWaitingLauncher(const QString &launcher);
+    Q_INVOKABLE bool waitingLauncherExists(const QString &launcher) const;
+
+signals:
+    void launcherListChanged();
+    void separatorsChanged();
+    void tasksModelChanged();
+    void waitingLaunchersChanged();
+    void waitingLauncherRemoved(QString launcher);
+
+private slots:
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsMoved(const QModelIndex &parent, int start, int end, const QModelIndex &destination, int row);
+    void rebuildIndexes();
+
+private:
+    struct TaskEntry {
+        QString launcherUrl;
+        QString appId;
+        bool isWindow{false};
+        bool isSeparator{false};
+    };
+
+    void addToIndexes(const TaskEntry &entry);
+    void removeFromIndexes(const TaskEntry &entry);
+    void updateRealTaskIndexes(bool forceSignal = false);
+
+    TaskEntry entryForRow(int row) const;
+
+    int m_launcherUrlRole{-1};
+    int m_appIdRole{-1};
+    int m_isWindowRole{-1};
+
+    int m_separatorsCount{0};
+    int m_firstRealTaskIndex{-1};
+    int m_lastRealTaskIndex{-1};
+
+    QStringList m_launcherList;
+    QSet<QString> m_launchers;
+    QSet<QString> m_waitingLaunchers;
+
+    //! top level rows of the tasks model in their order
+    QVector<TaskEntry> m_rows;
+    //! launcher url -> windows count
+    QHash<QString, int> m_tasksPerLauncher;
+    //! app id -> rows count
+    QHash<QString, int> m_rowsPerAppId;
+};
+
+}
+
+#endif // TASKSPROXYMODEL_H
@@ -32,94 +32,37 @@ import org.kde.latte 0.1 as Latte
 Item {
     id: parManager
 
-    property bool hasInternalSeparator: false
+    readonly property bool hasInternalSeparator: root.tasksProxyModel.separatorsCount > 0
 
-    property int firstRealTaskIndex: -1
-    property int lastRealTaskIndex: -1
+    readonly property int firstRealTaskIndex: root.tasksProxyModel.firstRealTaskIndex
+    readonly property int lastRealTaskIndex: root.tasksProxyModel.lastRealTaskIndex
 
     //tasks that change state (launcher,startup,window) and
     //at the next state must look the same
     //(id, mScale)
     property variant frozenTasks: []
 
-    //the internal separators in the form
-    //(launcherUrl, index)
-    property variant separators: []
-
     //new launchers in order to be moved in correct place
     //(launcher, pos)
     property variant launchersToBeMoved: []
 
     Connections{
         target: root
-        onTasksCountChanged:parManager.updateTasksEdgesIndexes();
         onDragSourceChanged: {
             if (!root.dragSource && parManager.hasInternalSeparator) {
-                //! Send the internal separators to other docks
-                var tasks = icList.contentItem.children;
-                var size = icList.contentItem.children.length;
-                var tempSeparatorsArray = [];
-                var tempSeparatorsIndexes = [];
-
-                for(var i=0; i<size; ++i){
-                    if (i>=icList.contentItem.children.length) {
-                        break;
-                    }
-
-                    if (tasks[i] && tasks[i].isSeparator) {
-                        tempSeparatorsArray.push(tasks[i].launcherUrl);
-                        tempSeparatorsIndexes.push(tasks[i].itemIndex);
-                    }
-                }
-
-                if (tempSeparatorsArray.length > 0) {
-                    if (latteDock && latteDock.launchersGroup >= Latte.Dock.LayoutLaunchers) {
-                        //reorder to lowest
-                        for(var i=0; i<tempSeparatorsIndexes.length; ++i) {
-                            var lowIndex = i;
-                            for(var j=i; j<tempSeparatorsIndexes.length; ++j) {
-                                if (tempSeparatorsIndexes[j]<tempSeparatorsIndexes[lowIndex]) {
-                                    lowIndex = j;
-                                }
-                            }
-
-                            if (lowIndex !== i) {
-                                //moving
-                                var tempInd = tempSeparatorsIndexes[lowIndex];
-                                tempSeparatorsIndexes.splice(lowIndex, 1);
-                                tempSeparatorsIndexes.splice(i, 0, tempInd);
-
-                                var tempName = tempSeparatorsArray[lowIndex];
-                                tempSeparatorsArray.splice(lowIndex, 1);
-                                tempSeparatorsArray.splice(i, 0, tempName);
-                            }
-                        }
-
-                        latteDock.universalLayoutManager.launchersSignals.internalSeparators(root.managedLayoutName,
-                                                                                             plasmoid.id,
-                                                                                             latteDock.launchersGroup,
-                                                                                             tempSeparatorsArray,
-                                                                                             tempSeparatorsIndexes);
-                    }
+                //! Send the internal separators to other docks, they are already
+                //! ordered by their task index
+                if (latteDock && latteDock.launchersGroup >= Latte.Dock.LayoutLaunchers) {
+                    latteDock.universalLayoutManager.launchersSignals.internalSeparators(root.managedLayoutName,
+                                                                                         plasmoid.id,
+                                                                                         latteDock.launchersGroup,
+                                                                                         root.tasksProxyModel.separators(),
+                                                                                         root.tasksProxyModel.separatorsIndexes());
                 }
             }
         }
     }
 
-    Component.onCompleted:  updateTasksEdgesIndexes();
-
-    function updateTasksEdgesIndexes() {
-        var newFirstTask = firstRealTask();
-        var newLastTask = lastRealTask();
-
-        if (newFirstTask !== firstRealTaskIndex || newLastTask !== lastRealTaskIndex ){
-            firstRealTaskIndex = newFirstTask;
-            lastRealTaskIndex = newLastTask;
-
-            root.separatorsUpdated();
-        }
-    }
-
     //!this is used in order to update the index when the signal is for applets
     //!outside the latte plasmoid
     function updateIdSendScale(index, zScale, zStep){
@@ -307,61 +250,6 @@ Item {
 
     //! SEPARATORS functions
 
-    // update the registered separators
-    // launcherUrl, no = add/update separator
-    // launcherUrl, -1 = remove separator
-
-    function setSeparator(launcher, taskIndex) {
-        var currentPos = separatorArrayPos(launcher);
-        var updated = false;
-
-        if (currentPos === -1 && taskIndex >=0){
-            //add that separator
-            //console.log("add separator:"+launcher+" at:"+taskIndex);
-            separators.push({launcherUrl: launcher, index: taskIndex});
-            updated = true;
-        } else if (currentPos>-1 && taskIndex === -1) {
-            //remove that separator
-            //console.log("remove separator:"+launcher);
-            separators.splice(currentPos,1);
-            updated = true;
-        } else if (currentPos>-1 && taskIndex>-1 && separators[currentPos].index !== taskIndex) {
-            //update that separator
-            //console.log("update separator:"+launcher+" from:"+separators[currentPos].index+" -> "+taskIndex);
-
-            separators[currentPos].index = taskIndex;
-            updated = true;
-        }
-
-        //if (separators.length > 0)
-        //    console.log(separators[0].launcherUrl+ " _________ " + separators[0].index);
-
-        if (updated) {
-            //console.log("message sent...");
-            hasInternalSeparator = separators.length > 0;
-
-            updateTasksEdgesIndexes();
-
-            root.separatorsUpdated();
-        }
-    }
-
-    function separatorArrayPos(launcher) {
-        var res = -1;
-        var sLength = separators.length;
-
-        for (var i=0; i<sLength; ++i) {
-            //!safety checker
-            if (i>=separators.length)
-                return false;
-
-            if (separators[i].launcherUrl === launcher)
-                return i;
-        }
-
-        return res;
-    }
-
     function availableLowerIndex(from) {
         var next = from;
 
@@ -385,18 +273,7 @@ Item {
     }
 
     function taskIsSeparator(taskIndex){
-        var sLength = separators.length;
-
-        for (var i=0; i<sLength; ++i) {
-            //!safety checker
-            if (i>=separators.length)
-                return false;
-
-            if (separators[i].index === taskIndex)
-                return true;
-        }
-
-        return false;
+        return root.tasksProxyModel.isSeparator(taskIndex);
     }
 
     function separatorExists(separator){
@@ -441,40 +318,6 @@ Item {
         return pseudoIndex;
     }
 
-    //! first available task index found after consequent internal separators in the start
-    function firstRealTask() {
-        if (hasInternalSeparator) {
-            var i=0;
-
-            while (i<=root.tasksCount-1) {
-                if (!taskIsSeparator(i)) {
-                    return i;
-                }
-
-                i = i + 1;
-            }
-        }
-
-        return root.tasksCount > 0 ? 0 : -1;
-    }
-
-    //! last available task index found after consequent internal separators in the end
-    function lastRealTask() {
-        if (hasInternalSeparator) {
-            var i=root.tasksCount - 1;
-
-            while (i>=0) {
-                if (!taskIsSeparator(i)) {
-                    return i;
-                }
-
-                i = i - 1;
-            }
-        }
-
-        return root.tasksCount > 0 ? root.tasksCount-1 : -1;
-    }
-
     function freeAvailableSeparatorName() {
         var available = false;
         var no = 1;
@@ -499,26 +342,7 @@ Item {
     }
 
     function lastPresentSeparatorName() {
-        var max = -1;
-        var arrayPos = -1;
-
-        var sLength = separators.length;
-
-        for (var i=0; i<sLength; ++i) {
-            //!safety checker
-            if (i>=separators.length)
-                return false;
-
-            if (separators[i].index > max) {
-                max = separators[i].index;
-                arrayPos = i;
-            }
-        }
-
-        if (arrayPos>-1)
-            return separators[arrayPos].launcherUrl;
-        else
-            return "";
+        return root.tasksProxyModel.lastSeparator();
     }
 
     //! launchersToBeMoved, new launchers to have been added and must be repositioned
@@ -608,10 +432,6 @@ Item {
                                                                            plasmoid.id, latteDock.launchersGroup, from, to);
             }
 
-            if (isSeparator(launcherUrl)) {
-                setSeparator(launcherUrl,to);
-            }
-
             tasksModel.syncLaunchers();
         }
     }
@@ -100,13 +100,13 @@ Item {
     //in launcher reference from libtaskmanager
     property variant badgers:[]
     property variant launchersOnActivities: []
-    property variant waitingLaunchers: []
 
     //global plasmoid reference to the context menu
     property QtObject contextMenu: null
     property QtObject contextMenuComponent: Qt.createComponent("ContextMenu.qml");
     property Item dragSource: null
     property Item parabolicManager: _parabolicManager
+    property QtObject tasksProxyModel: _tasksProxyModel
 
     property color minimizedDotColor: textColorLuma > 0.5 ? Qt.darker(theme.textColor, 1+ (1-textColorLuma)) : Qt.lighter(theme.textColor, 1+(1-textColorLuma))
 
@@ -239,8 +239,12 @@ Item {
             plasmoid.configuration.isInLatteDock = true;
         else
             plasmoid.configuration.isInLatteDock = false;
+
+        registerLaunchersSignalsEndpoint();
     }
 
+    onManagedLayoutNameChanged: registerLaunchersSignalsEndpoint();
+
 
     Connections {
         target: plasmoid
@@ -294,19 +298,11 @@ Item {
 
     ///UPDATE
     function launcherExists(url) {
-        return (ActivitiesTools.getIndex(url, tasksModel.launcherList)>=0);
+        return _tasksProxyModel.launcherExists(url);
     }
 
     function taskExists(url) {
-        var tasks = icList.contentItem.children;
-        for(var i=0; i<tasks.length; ++i){
-            var task = tasks[i];
-
-            if (task.launcherUrl===url && task.isWindow) {
-                return true;
-            }
-        }
-        return false;
+        return _tasksProxyModel.taskExists(url);
     }
 
     function launchersDrop(event) {
@@ -324,33 +320,15 @@ Item {
     /// waiting launchers... this is used in order to check
     /// a window or startup if its launcher is playing its animation
     function addWaitingLauncher(launch){
-        for(var i=0; i<waitingLaunchers.length; ++i){
-            if (waitingLaunchers[i]===launch) {
-                return;
-            }
-        }
-
-        waitingLaunchers.push(launch);
+        _tasksProxyModel.addWaitingLauncher(launch);
     }
 
     function removeWaitingLauncher(launch){
-        for(var i=0; i<waitingLaunchers.length; ++i){
-            if (waitingLaunchers[i]===launch) {
-                waitingLaunchers.splice(i,1);
-                waitingLauncherRemoved(launch);
-                return;
-            }
-        }
+        _tasksProxyModel.removeWaitingLauncher(launch);
     }
 
     function waitingLauncherExists(launch){
-        for(var i=0; i<waitingLaunchers.length; ++i){
-            if (waitingLaunchers[i]===launch) {
-                return true;
-            }
-        }
-
-        return false;
+        return _tasksProxyModel.waitingLauncherExists(launch);
     }
 
     onDragSourceChanged: {
@@ -652,6 +630,16 @@ Item {
         }
     }
 
+    //! indexes for launchers, tasks and separators of the tasksModel
+    Latte.TasksProxyModel {
+        id: _tasksProxyModel
+        tasksModel: tasksModel
+        launcherList: tasksModel.launcherList
+
+        onWaitingLauncherRemoved: root.waitingLauncherRemoved(launcher);
+        onSeparatorsChanged: root.separatorsUpdated();
+    }
+
     //! TaskManagerBackend required a groupDialog setting otherwise it crashes. This patch
     //! sets one just in order not to crash TaskManagerBackend
     PlasmaCore.Dialog {
@@ -858,7 +846,7 @@ Item {
             if(root.latteDock)
                 console.log("Plasmoid, enableDirectRenderTimer was called, even though it shouldnt...");
 
-            if (waitingLaunchers.length > 0)
+            if (_tasksProxyModel.waitingLaunchersCount > 0)
                 restart();
             else
                 icList.directRender = true;
@@ -1427,6 +1415,12 @@ Item {
     }
 
     //! BEGIN ::: external launchers signals in order to update the tasks model
+    function registerLaunchersSignalsEndpoint() {
+        if (latteDock && latteDock.universalLayoutManager) {
+            latteDock.universalLayoutManager.launchersSignals.registerEndpoint(root.managedLayoutName, plasmoid.id, root);
+        }
+    }
+
     function extSignalAddLauncher(group, launcher) {
         if (group === latteDock.launchersGroup) {
             tasksModel.requestAddLauncher(launcher);
@@ -1517,7 +1511,8 @@ Item {
             parabolicManager.addLauncherToBeMoved(separatorName, Math.max(0,pos));
 
             if (latteDock && latteDock.launchersGroup >= Latte.Dock.LayoutLaunchers) {
-                latteDock.universalLayoutManager.launchersSignals.addLauncher(latteDock.launchersGroup, separatorName);
+                latteDock.universalLayoutManager.launchersSignals.addLauncher(root.managedLayoutName,
+                                                                              latteDock.launchersGroup, separatorName);
             } else {
                 tasksModel.requestAddLauncher(separatorName);
             }
@@ -1659,6 +1654,10 @@ Item {
     }
 
     Component.onDestruction: {
+        if (latteDock && latteDock.universalLayoutManager) {
+            latteDock.universalLayoutManager.launchersSignals.unregisterEndpoint(root);
+        }
+
         root.presentWindows.disconnect(backend.presentWindows);
         root.windowsHovered.disconnect(backend.windowsHovered);
         dragHelper.dropped.disconnect(resetDragSource);
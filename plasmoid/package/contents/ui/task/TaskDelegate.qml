@@ -317,10 +317,6 @@ MouseArea{
             onEditModeChanged: separatorItem.updateForceHiddenState();
             onDragSourceChanged: {
                 separatorItem.updateForceHiddenState();
-
-                if (isSeparator && !root.dragSource) {
-                    parabolicManager.setSeparator(launcherUrl, itemIndex);
-                }
             }
             onSeparatorsUpdated: separatorItem.updateForceHiddenState();
         }
@@ -441,10 +437,6 @@ MouseArea{
     onItemIndexChanged: {
         if (itemIndex>=0)
             lastValidTimer.start();
-
-        if (isSeparator){
-            parabolicManager.setSeparator(launcherUrl, itemIndex);
-        }
     }
 
     onIsDraggedChanged: {
@@ -473,13 +465,9 @@ MouseArea{
 
     onIsSeparatorChanged: {
         if (isSeparator) {
-            parabolicManager.setSeparator(launcherUrl, itemIndex);
-
             if (parabolicManager.isLauncherToBeMoved(launcherUrl) && itemIndex>=0) {
                 parabolicManager.moveLauncherToCorrectPos(launcherUrl, itemIndex);
             }
-        } else {
-            parabolicManager.setSeparator(launcherUrl, -1);
         }
     }
 
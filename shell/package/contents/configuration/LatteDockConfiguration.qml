@@ -344,16 +344,23 @@ FocusScope {
                         id: behaviorPage
                     }
 
-                    AppearanceConfig {
+                    //! the rest pages are created the first time they are shown
+                    LazyPage {
                         id: appearancePage
+                        isCurrent: tabGroup.currentTab === appearancePage
+                        sourceComponent: AppearanceConfig {}
                     }
 
-                    TasksConfig {
+                    LazyPage {
                         id: tasksPage
+                        isCurrent: tabGroup.currentTab === tasksPage
+                        sourceComponent: TasksConfig {}
                     }
 
-                    TweaksConfig {
+                    LazyPage {
                         id: tweaksPage
+                        isCurrent: tabGroup.currentTab === tweaksPage
+                        sourceComponent: TweaksConfig {}
                     }
                 }
             }
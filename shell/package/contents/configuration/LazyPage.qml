@@ -0,0 +1,48 @@
+/*
+*  Copyright 2018  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.3
+
+import org.kde.plasma.components 2.0 as PlasmaComponents
+
+//! A settings page that creates its contents the first time it is shown
+PlasmaComponents.Page {
+    id: page
+
+    property bool isCurrent: false
+    property Component sourceComponent
+
+    Layout.maximumWidth: loader.item ? loader.item.Layout.maximumWidth : 0
+    Layout.maximumHeight: loader.item ? loader.item.Layout.maximumHeight : 0
+
+    onIsCurrentChanged: {
+        if (isCurrent) {
+            loader.active = true;
+        }
+    }
+
+    Loader {
+        id: loader
+        anchors.fill: parent
+        active: false
+        sourceComponent: page.sourceComponent
+    }
+}